@@ -1,7 +1,8 @@
-// main.qml
+// Main.qml
 import QtQuick
 import QtQuick.Controls
 import QtQuick.Layouts
+import QtQuick.Dialogs
 import SpeechRecognition 1.0
 
 ApplicationWindow {
@@ -14,53 +15,270 @@ ApplicationWindow {
         id: recognizer
     }
 
+    // 由 main.cpp 在第一帧显示之后调用
+    function warmUp() {
+        recognizer.warmUp()
+    }
+
+    FileDialog {
+        id: audioFileDialog
+        title: "选择音频文件"
+        nameFilters: ["音频文件 (*.wav *.pcm)", "所有文件 (*)"]
+        onAccepted: recognizer.transcribeFile(selectedFile)
+    }
+
     ColumnLayout {
         anchors.fill: parent
         anchors.margins: 20
         spacing: 20
 
-        // 录音按钮
-        Rectangle {
+        // 按钮行
+        RowLayout {
             Layout.alignment: Qt.AlignHCenter
-            width: 80
-            height: 80
-            radius: width / 2
-            color: recognizer.recording ? "red" : "green"
+            spacing: 20
 
-            MouseArea {
-                anchors.fill: parent
-                onClicked: {
-                    if (!recognizer.recording) {
-                        recognizer.startRecording()
-                    } else {
-                        recognizer.stopRecording()
+            // 录音按钮
+            Rectangle {
+                width: 80
+                height: 80
+                radius: width / 2
+                color: recognizer.recording ? "red" : "green"
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        if (!recognizer.recording) {
+                            recognizer.startRecording()
+                        } else {
+                            recognizer.stopRecording()
+                        }
+                    }
+                }
+
+                Text {
+                    anchors.centerIn: parent
+                    text: recognizer.recording ? "停止" : "录音"
+                    color: "white"
+                    font.bold: true
+                }
+            }
+
+            // 听音模式：常开采集，有人说话时才上传；说话时按钮变为橙色
+            Rectangle {
+                width: 80
+                height: 80
+                radius: width / 2
+                color: !recognizer.listening ? "#607D8B"
+                                             : (recognizer.speaking ? "orange" : "#8BC34A")
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        if (!recognizer.listening) {
+                            recognizer.startListening()
+                        } else {
+                            recognizer.stopListening()
+                        }
+                    }
+                }
+
+                Text {
+                    anchors.centerIn: parent
+                    text: recognizer.listening ? "停止聆听" : "聆听"
+                    color: "white"
+                    font.bold: true
+                }
+            }
+
+            // 测试按钮
+            Rectangle {
+                width: 80
+                height: 80
+                radius: width / 2
+                color: "#2196F3"
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        recognizer.testPcmFile()
+                    }
+                }
+
+                Text {
+                    anchors.centerIn: parent
+                    text: "测试PCM"
+                    color: "white"
+                    font.bold: true
+                }
+            }
+
+            // 8k 测试录音，验证重采样路径
+            Rectangle {
+                width: 80
+                height: 80
+                radius: width / 2
+                color: "#3F51B5"
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        recognizer.testPcmFile(8000)
+                    }
+                }
+
+                Text {
+                    anchors.centerIn: parent
+                    text: "测试8k"
+                    color: "white"
+                    font.bold: true
+                }
+            }
+            // 识别任意 WAV/PCM 文件
+            Rectangle {
+                width: 80
+                height: 80
+                radius: width / 2
+                color: "#009688"
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        audioFileDialog.open()
                     }
                 }
+
+                Text {
+                    anchors.centerIn: parent
+                    text: "选择文件"
+                    color: "white"
+                    font.bold: true
+                }
             }
 
-            Text {
-                anchors.centerIn: parent
-                text: recognizer.recording ? "停止" : "录音"
-                color: "white"
-                font.bold: true
+            Rectangle {
+                width: 80
+                height: 80
+                radius: width / 2
+                color: "green"
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        recognizer.testMicrophone()
+                    }
+                }
+
+                Text {
+                    anchors.centerIn: parent
+                    text: "测麦"
+                    color: "white"
+                    font.bold: true
+                }
             }
+
         }
 
-        // 识别结果显示区域
-        ScrollView {
+        // 音量条：录音和测麦时实时显示输入电平
+        Rectangle {
+            Layout.fillWidth: true
+            height: 12
+            radius: height / 2
+            color: "#E0E0E0"
+
+            Rectangle {
+                width: parent.width * recognizer.level
+                height: parent.height
+                radius: parent.radius
+                color: recognizer.peakLevel > 0.95 ? "red"
+                                                   : (recognizer.level > 0.7 ? "orange" : "#4CAF50")
+
+                Behavior on width {
+                    NumberAnimation { duration: 50 }
+                }
+            }
+
+            // 峰值指示
+            Rectangle {
+                x: (parent.width - width) * recognizer.peakLevel
+                width: 2
+                height: parent.height
+                color: "#424242"
+                visible: recognizer.peakLevel > 0
+            }
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+
+            // 输入设备，第一项为系统默认设备
+            ComboBox {
+                Layout.fillWidth: true
+                model: recognizer.inputDevices
+                currentIndex: recognizer.inputDevice
+                enabled: !recognizer.recording && !recognizer.listening
+                onActivated: (index) => recognizer.inputDevice = index
+            }
+
+            CheckBox {
+                id: metricsToggle
+                text: "显示性能指标"
+            }
+        }
+
+        // 识别结果显示区域：每行一个结果分段，只有变化的分段重新布局；
+        // 仍可能被动态修正替换的分段以灰色显示
+        Rectangle {
             Layout.fillWidth: true
             Layout.fillHeight: true
+            color: "white"
+            border.color: "gray"
+            radius: 5
 
-            TextArea {
-                text: recognizer.text
-                readOnly: true
-                wrapMode: TextArea.Wrap
-                background: Rectangle {
-                    color: "white"
-                    border.color: "gray"
-                    radius: 5
+            ListView {
+                id: transcriptView
+                anchors.fill: parent
+                anchors.margins: 6
+                clip: true
+                model: recognizer.transcript
+                onCountChanged: positionViewAtEnd()
+
+                delegate: Text {
+                    width: transcriptView.width
+                    text: model.text
+                    wrapMode: Text.Wrap
+                    color: model.stable ? "black" : "gray"
                 }
+
+                ScrollBar.vertical: ScrollBar {}
             }
         }
     }
+
+    // 性能指标面板：延迟为直方图估算的分位数 (ms)
+    Rectangle {
+        anchors.top: parent.top
+        anchors.right: parent.right
+        anchors.margins: 10
+        width: metricsText.implicitWidth + 16
+        height: metricsText.implicitHeight + 12
+        radius: 4
+        color: "#CC212121"
+        visible: metricsToggle.checked
+
+        Text {
+            id: metricsText
+            anchors.centerIn: parent
+            color: "white"
+            font.family: "monospace"
+            font.pixelSize: 11
+            text: "采集→发送 p50/p95: " + recognizer.captureToSendP50.toFixed(1)
+                  + " / " + recognizer.captureToSendP95.toFixed(1)
+                  + "\n发送→结果 p50: " + recognizer.sendToResultP50.toFixed(1)
+                  + "\n首个结果 p50: " + recognizer.firstResultP50.toFixed(1)
+                  + "\n已发送帧: " + recognizer.framesSent
+                  + "  静音跳过: " + recognizer.framesSilent
+                  + "\n上传: " + (recognizer.bytesUploaded / 1024).toFixed(0) + " KB"
+                  + "  服务端错误: " + recognizer.serverErrors
+        }
+    }
 }
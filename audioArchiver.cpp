@@ -0,0 +1,265 @@
+#include "audioArchiver.h"
+#include "iatProtocol.h"
+#include "pipelineMetrics.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QtEndian>
+#include <QDebug>
+
+#include <cstring>
+
+namespace {
+constexpr quint32 PLACEHOLDER_SIZE = 0xFFFFFFFF;  // 录音中的 RIFF/data 长度，读取方按实际文件长度处理
+constexpr int FMT_CHUNK_BYTES = 8 + 16;
+constexpr int MAX_NAME_ATTEMPTS = 100;
+}
+
+AudioArchiver::AudioArchiver(QObject *parent)
+    : PipelineStage(parent)
+    , m_blocks(POOL_BLOCKS + 4)  // 音频块至多 POOL_BLOCKS 个，其余留给会话开始/结束消息
+    , m_freeBlocks(POOL_BLOCKS)
+{
+}
+
+AudioArchiver::~AudioArchiver()
+{
+    // 生产端此时已经删除：写完剩余的块，未正常结束的会话同样补全文件头
+    process();
+    closeFile(0);
+}
+
+QByteArray AudioArchiver::wavHeader(qint64 dataBytes)
+{
+    // RIFF 头 12 字节 + fmt 块 24 字节 + JUNK 块 + data 块头 8 字节，共 HEADER_BYTES
+    const quint32 dataSize = dataBytes < 0 ? PLACEHOLDER_SIZE
+                                           : quint32(qMin<qint64>(dataBytes, PLACEHOLDER_SIZE - HEADER_BYTES));
+    const quint32 riffSize = dataBytes < 0 ? PLACEHOLDER_SIZE : quint32(HEADER_BYTES - 8 + dataSize);
+    const quint32 junkSize = quint32(HEADER_BYTES - 12 - FMT_CHUNK_BYTES - 8 - 8);
+
+    QByteArray header(HEADER_BYTES, '\0');
+    char *p = header.data();
+    auto putTag = [&p](const char *tag) {
+        memcpy(p, tag, 4);
+        p += 4;
+    };
+    auto put32 = [&p](quint32 value) {
+        qToLittleEndian(value, p);
+        p += 4;
+    };
+    auto put16 = [&p](quint16 value) {
+        qToLittleEndian(value, p);
+        p += 2;
+    };
+
+    putTag("RIFF");
+    put32(riffSize);
+    putTag("WAVE");
+
+    putTag("fmt ");
+    put32(16);
+    put16(1);                // PCM
+    put16(1);                // 单声道
+    put32(SAMPLE_RATE);
+    put32(BYTES_PER_MS * 1000);
+    put16(2);                // 每个采样帧的字节数
+    put16(16);
+
+    putTag("JUNK");
+    put32(junkSize);
+    p += junkSize;
+
+    putTag("data");
+    put32(dataSize);
+    return header;
+}
+
+void AudioArchiver::beginSession(const QString &directory)
+{
+    endSession();
+    if (directory.isEmpty()) {
+        return;
+    }
+
+    ArchiveBlock block;
+    block.kind = ArchiveBlock::Begin;
+    block.directory = directory;
+    // 保留一个空位，保证之后的结束消息总能放进队列
+    if (!pushBlock(std::move(block), 1)) {
+        qDebug() << "Audio archive queue is full, this session will not be archived";
+        return;
+    }
+    m_feeding = true;
+    m_droppedBytes = 0;
+}
+
+void AudioArchiver::append(QByteArrayView pcm)
+{
+    if (!m_feeding) {
+        return;
+    }
+
+    while (!pcm.isEmpty()) {
+        if (m_pending.isEmpty()) {
+            // m_pending 为空表示手上没有块：先复用写完的块，池未用满时才分配新块
+            if (!m_freeBlocks.pop(m_pending)) {
+                if (m_allocatedBlocks >= POOL_BLOCKS) {
+                    // 归档线程跟不上：丢弃这部分音频，不等待磁盘
+                    m_droppedBytes += pcm.size();
+                    if (m_metrics) {
+                        m_metrics->add(PipelineMetrics::ArchiveBytesDropped, quint64(pcm.size()));
+                    }
+                    return;
+                }
+                ++m_allocatedBlocks;
+            }
+            m_pending.resize(BLOCK_BYTES);
+            m_pendingSize = 0;
+        }
+
+        const qint64 count = qMin<qint64>(pcm.size(), BLOCK_BYTES - m_pendingSize);
+        memcpy(m_pending.data() + m_pendingSize, pcm.data(), count);
+        m_pendingSize += count;
+        pcm = pcm.sliced(count);
+
+        if (m_pendingSize == BLOCK_BYTES) {
+            flushPending();
+        }
+    }
+}
+
+void AudioArchiver::endSession()
+{
+    if (!m_feeding) {
+        return;
+    }
+    flushPending();
+
+    ArchiveBlock block;
+    block.kind = ArchiveBlock::End;
+    block.droppedBytes = m_droppedBytes;
+    if (!pushBlock(std::move(block), 0)) {
+        qDebug() << "Audio archive queue is full, the archive will be closed with the next session";
+    }
+    m_feeding = false;
+}
+
+void AudioArchiver::flushPending()
+{
+    if (m_pending.isEmpty() || m_pendingSize == 0) {
+        return;
+    }
+
+    ArchiveBlock block;
+    block.pcm = std::move(m_pending);
+    block.pcm.resize(m_pendingSize);  // 只截短，不释放容量，块归还后可直接复用
+    const qint64 size = m_pendingSize;
+    m_pendingSize = 0;
+
+    if (!pushBlock(std::move(block), 1)) {
+        // 会话消息占满了队列：这一块丢弃，缓冲区留着接着用
+        m_droppedBytes += size;
+        if (m_metrics) {
+            m_metrics->add(PipelineMetrics::ArchiveBytesDropped, quint64(size));
+        }
+        m_pending = std::move(block.pcm);
+        m_pending.resize(BLOCK_BYTES);
+    }
+}
+
+bool AudioArchiver::pushBlock(ArchiveBlock &&block, size_t reservedSlots)
+{
+    if (m_blocks.freeSlots() <= reservedSlots || !m_blocks.push(std::move(block))) {
+        return false;
+    }
+    wake();
+    return true;
+}
+
+void AudioArchiver::process()
+{
+    ArchiveBlock block;
+    while (m_blocks.pop(block)) {
+        switch (block.kind) {
+        case ArchiveBlock::Begin:
+            // 上一个会话的结束消息没能入队时，在这里结束它
+            closeFile(0);
+            openFile(block.directory);
+            break;
+        case ArchiveBlock::Audio:
+            writeAudio(block.pcm);
+            m_freeBlocks.push(std::move(block.pcm));
+            break;
+        case ArchiveBlock::End:
+            closeFile(block.droppedBytes);
+            break;
+        }
+    }
+}
+
+void AudioArchiver::openFile(const QString &directory)
+{
+    m_dataBytes = 0;
+    m_writeFailed = false;
+
+    if (!QDir().mkpath(directory)) {
+        qDebug() << "Cannot create audio archive directory" << directory;
+        return;
+    }
+
+    // 多个会话可能在同一毫秒开始，NewOnly 保证不会覆盖已有的归档
+    const QString stem = QDir(directory).filePath(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz"));
+    for (int attempt = 0; attempt < MAX_NAME_ATTEMPTS && !m_file.isOpen(); ++attempt) {
+        m_file.setFileName(attempt == 0 ? stem + ".wav" : QString("%1-%2.wav").arg(stem).arg(attempt));
+        // 不经过 QFile 的缓冲，每次写入直接交给系统
+        m_file.open(QIODevice::WriteOnly | QIODevice::NewOnly | QIODevice::Unbuffered);
+    }
+    if (!m_file.isOpen()) {
+        qDebug() << "Cannot create audio archive in" << directory << ":" << m_file.errorString();
+        return;
+    }
+
+    const QByteArray header = wavHeader(-1);
+    if (m_file.write(header) != header.size()) {
+        qDebug() << "Failed to write audio archive" << m_file.fileName() << ":" << m_file.errorString();
+        m_writeFailed = true;
+    }
+}
+
+void AudioArchiver::writeAudio(const QByteArray &pcm)
+{
+    if (!m_file.isOpen() || m_writeFailed) {
+        return;
+    }
+    const qint64 written = m_file.write(pcm);
+    if (written != pcm.size()) {
+        // 磁盘已满或出错：保留已写入的部分，本次会话不再写入
+        qDebug() << "Failed to write audio archive" << m_file.fileName() << ":" << m_file.errorString();
+        m_writeFailed = true;
+    }
+    if (written > 0) {
+        m_dataBytes += written;
+        if (m_metrics) {
+            m_metrics->add(PipelineMetrics::ArchiveBytesWritten, quint64(written));
+        }
+    }
+}
+
+void AudioArchiver::closeFile(qint64 droppedBytes)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    // 回写实际长度，文件头同样是一次整页写入
+    const QByteArray header = wavHeader(m_dataBytes);
+    if (!m_file.seek(0) || m_file.write(header) != header.size()) {
+        qDebug() << "Failed to finalize audio archive header" << m_file.fileName() << ":" << m_file.errorString();
+    }
+    const QString path = m_file.fileName();
+    m_file.close();
+
+    qDebug() << "Session audio archived to" << path << "duration:" << m_dataBytes / BYTES_PER_MS << "ms"
+             << "dropped:" << droppedBytes / BYTES_PER_MS << "ms";
+    emit archiveFinished(path, m_dataBytes);
+}
@@ -0,0 +1,86 @@
+#ifndef AUDIOARCHIVER_H
+#define AUDIOARCHIVER_H
+
+#include "pipelineStage.h"
+#include "spscQueue.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+
+// 交给归档线程的一条消息：开始一个会话、一块音频或结束会话
+struct ArchiveBlock
+{
+    enum Kind {
+        Begin,
+        Audio,
+        End
+    };
+
+    Kind kind = Audio;
+    QByteArray pcm;           // Audio：整块音频，只有会话末尾的一块可能不满
+    QString directory;        // Begin：归档目录
+    qint64 droppedBytes = 0;  // End：本次会话因写入跟不上而丢弃的字节数
+};
+
+// 会话音频归档：把预处理后的 16k 单声道 PCM 边录边写成 WAV 文件，用于审计和复现问题。
+// 生产端 (预处理阶段) 把音频拷进固定大小的块，满一块才交给归档线程；块缓冲区来自固定数量的池，
+// 写完后归还复用，内存占用与会话时长无关。磁盘跟不上、池中没有空闲块时丢弃新音频并计数，
+// 从不阻塞采集和识别。
+// 文件头 (含 JUNK 填充) 恰好占 HEADER_BYTES，之后每次写入一整块，文件偏移和长度都按页对齐；
+// 录音期间文件头中的长度为占位值 0xFFFFFFFF，会话结束时回写实际长度。
+class AudioArchiver : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 HEADER_BYTES = 4096;
+    static constexpr qint64 BLOCK_BYTES = 64 * 1024;  // 约 2 秒音频
+    static constexpr int POOL_BLOCKS = 32;            // 归档线程最多落后约 1 分钟音频
+
+    explicit AudioArchiver(QObject *parent = nullptr);
+    // 写完队列中剩余的音频并补全文件头
+    ~AudioArchiver() override;
+
+    // 以下三个函数只能在生产线程中调用，从不阻塞。
+    // 开始新会话：未结束的上一个会话先结束；directory 为空时本次会话不归档
+    void beginSession(const QString &directory);
+    void append(QByteArrayView pcm);
+    void endSession();
+
+    // 指定数据长度的 WAV 文件头，dataBytes < 0 时为录音中的占位值
+    static QByteArray wavHeader(qint64 dataBytes);
+
+signals:
+    // 在归档线程发出：一次会话的文件已补全文件头并关闭
+    void archiveFinished(const QString &path, qint64 dataBytes);
+
+protected:
+    void process() override;
+
+private:
+    bool pushBlock(ArchiveBlock &&block, size_t reservedSlots);
+    void flushPending();
+
+    void openFile(const QString &directory);
+    void writeAudio(const QByteArray &pcm);
+    void closeFile(qint64 droppedBytes);
+
+    SpscQueue<ArchiveBlock> m_blocks;
+    SpscQueue<QByteArray> m_freeBlocks;  // 归档线程写完的块缓冲区归还给生产端
+
+    // 生产端状态
+    bool m_feeding = false;
+    QByteArray m_pending;    // 正在填充的块，容量固定为 BLOCK_BYTES
+    qint64 m_pendingSize = 0;
+    int m_allocatedBlocks = 0;
+    qint64 m_droppedBytes = 0;
+
+    // 归档线程状态
+    QFile m_file;
+    qint64 m_dataBytes = 0;
+    bool m_writeFailed = false;
+};
+
+#endif // AUDIOARCHIVER_H
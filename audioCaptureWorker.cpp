@@ -0,0 +1,256 @@
+#include "audioCaptureWorker.h"
+#include "audioRingBuffer.h"
+#include "audioFileSource.h"
+#include "iatProtocol.h"
+
+#include <QAudioSource>
+#include <QAudioDevice>
+#include <QMediaDevices>
+#include <QTimer>
+#include <QDebug>
+
+#include <limits>
+
+namespace {
+constexpr int FEED_INTERVAL_MS = 20;  // 实时回放文件时每次写入的音频时长，与常见声卡周期相当
+constexpr qint64 FILE_CHUNK_BYTES = 64 * 1024;  // 每次从文件读取的原始数据量
+constexpr int FILE_CHUNKS_PER_TURN = 4;  // 一次 process() 最多读取的块数，之后让出线程给其他会话
+}
+
+AudioCaptureWorker::AudioCaptureWorker(qint64 ringCapacity, QObject *parent)
+    : PipelineStage(parent)
+    , m_ring(new AudioRingBuffer(ringCapacity, MAX_FRAME_SIZE, this))
+    , m_feedTimer(new QTimer(this))
+{
+    m_feedTimer->setTimerType(Qt::PreciseTimer);
+    m_feedTimer->setInterval(FEED_INTERVAL_MS);
+    connect(m_feedTimer, &QTimer::timeout, this, &AudioCaptureWorker::process);
+}
+
+void AudioCaptureWorker::setInput(const QByteArray &deviceId, int channel)
+{
+    if (deviceId == m_deviceId && channel == m_channel) {
+        return;
+    }
+    m_deviceId = deviceId;
+    m_channel = channel;
+
+    // 下次 initialize() 时按新设备重新创建
+    if (m_audioSource) {
+        m_audioSource->stop();
+        delete m_audioSource;
+        m_audioSource = nullptr;
+        m_deviceIo = nullptr;
+    }
+}
+
+void AudioCaptureWorker::initialize()
+{
+    if (m_audioSource) {
+        return;
+    }
+
+    // 打印所有可用的音频输入设备，按 id 查找指定设备；设备列表同时交给界面
+    QAudioDevice inputDevice = QMediaDevices::defaultAudioInput();
+    QStringList names;
+    QList<QByteArray> ids;
+    qDebug() << "Available audio input devices:";
+    for (const QAudioDevice &device : QMediaDevices::audioInputs()) {
+        qDebug() << " - " << device.description();
+        names.append(device.description());
+        ids.append(device.id());
+        if (!m_deviceId.isEmpty() && device.id() == m_deviceId) {
+            inputDevice = device;
+        }
+    }
+    emit devicesEnumerated(names, ids);
+    if (!m_deviceId.isEmpty() && inputDevice.id() != m_deviceId) {
+        qWarning() << "Audio input" << m_deviceId << "not found, using the default device";
+    }
+    qDebug() << "Using audio input:" << inputDevice.description();
+
+    m_format.setSampleRate(SAMPLE_RATE);
+    m_format.setChannelCount(1);
+    m_format.setSampleFormat(QAudioFormat::Int16);
+
+    // 选取单个声道时需要设备的原生多声道格式
+    if (m_channel >= 0 || !inputDevice.isFormatSupported(m_format)) {
+        if (m_channel < 0) {
+            qWarning() << "Default format not supported, trying to use nearest format";
+        }
+        m_format = inputDevice.preferredFormat();
+    }
+
+    qDebug() << "Using audio format:"
+             << "\nSample rate:" << m_format.sampleRate()
+             << "\nChannels:" << m_format.channelCount()
+             << "\nSample format:" << m_format.sampleFormat()
+             << "\nBytes per frame:" << m_format.bytesPerFrame();
+
+    // 设备不支持目标格式时，由转换器负责混音 (或选取声道)、格式转换和重采样
+    if (!m_converter.setInputFormat(m_format, m_channel)) {
+        qWarning() << "Audio from this device cannot be converted to 16 kHz mono Int16";
+    }
+
+    // QAudioSource 在采集线程中创建，回调和写入都不经过 GUI 线程
+    m_audioSource = new QAudioSource(inputDevice, m_format, this);
+    m_audioSource->setBufferSize(32768);  // 增大缓冲区大小
+
+    // 监控音频状态
+    connect(m_audioSource, &QAudioSource::stateChanged,
+            this, [this](QAudio::State state) {
+                qDebug() << "Audio state changed:" << state;
+                if (state == QAudio::StoppedState && m_audioSource->error() != QAudio::NoError) {
+                    qDebug() << "Audio error:" << m_audioSource->error();
+                }
+            });
+    emit initialized();
+}
+
+void AudioCaptureWorker::enumerateDevices()
+{
+    QStringList names;
+    QList<QByteArray> ids;
+    for (const QAudioDevice &device : QMediaDevices::audioInputs()) {
+        names.append(device.description());
+        ids.append(device.id());
+    }
+    emit devicesEnumerated(names, ids);
+}
+
+void AudioCaptureWorker::startDevice()
+{
+    initialize();
+    m_converter.setInputFormat(m_format, m_channel);
+
+    if (m_converter.isPassthrough()) {
+        m_audioSource->start(m_ring);
+        return;
+    }
+
+    // 需要转换：由 QAudioSource 提供缓冲设备，数据到达后在本线程转换再写入环形缓冲区
+    m_deviceIo = m_audioSource->start();
+    if (m_deviceIo) {
+        connect(m_deviceIo, &QIODevice::readyRead, this, &AudioCaptureWorker::readDevice,
+                Qt::UniqueConnection);
+    }
+}
+
+void AudioCaptureWorker::readDevice()
+{
+    if (!m_deviceIo) {
+        return;
+    }
+
+    const qint64 available = m_deviceIo->bytesAvailable();
+    if (available <= 0) {
+        return;
+    }
+
+    m_deviceBuffer.resize(available);
+    const qint64 size = m_deviceIo->read(m_deviceBuffer.data(), available);
+    if (size <= 0) {
+        return;
+    }
+
+    const QByteArrayView converted = m_converter.convert(QByteArrayView(m_deviceBuffer.constData(), size));
+    m_ring->write(converted.data(), converted.size());
+}
+
+void AudioCaptureWorker::startFile(std::shared_ptr<AudioFileSource> source, bool realTime)
+{
+    m_converter.setInputFormat(source->format());
+    m_file = std::move(source);
+    m_fileOutput = QByteArrayView();
+    m_fileWritten = 0;
+    m_realTimeFeed = realTime;
+    if (realTime) {
+        m_feedClock.start();
+        m_feedTimer->start();
+    }
+    process();
+}
+
+void AudioCaptureWorker::stop()
+{
+    // 转换路径下设备中可能还有未读取的数据，停止前取出
+    readDevice();
+    m_deviceIo = nullptr;
+    if (m_audioSource) {
+        m_audioSource->stop();
+    }
+    // 文件输入被提前停止时，未写入的部分直接丢弃
+    m_feedTimer->stop();
+    m_file.reset();
+    m_fileOutput = QByteArrayView();
+    m_ring->closeWriteChannel();
+}
+
+void AudioCaptureWorker::reset()
+{
+    if (m_audioSource) {
+        m_audioSource->stop();
+    }
+    m_deviceIo = nullptr;
+    m_feedTimer->stop();
+    m_file.reset();
+    m_fileOutput = QByteArrayView();
+}
+
+void AudioCaptureWorker::process()
+{
+    if (!m_file) {
+        return;
+    }
+
+    // 实时回放时只放行到当前时刻为止"采集"到的音频
+    qint64 allowed = std::numeric_limits<qint64>::max();
+    if (m_realTimeFeed) {
+        allowed = m_feedClock.elapsed() / FEED_INTERVAL_MS * FEED_INTERVAL_MS * BYTES_PER_MS - m_fileWritten;
+    }
+
+    int chunks = 0;
+    for (;;) {
+        if (m_fileOutput.isEmpty()) {
+            if (m_file->atEnd()) {
+                finishFile();
+                return;
+            }
+            if (chunks++ == FILE_CHUNKS_PER_TURN) {
+                // 与其他会话共用采集线程时轮流转换，稍后继续
+                wake();
+                return;
+            }
+            // 转换结果的视图在下次 convert() 前有效，文件视图在下次 read() 前有效，
+            // 因此只在上一块全部写入后才读取下一块
+            const QByteArrayView input = m_file->read(FILE_CHUNK_BYTES);
+            if (input.isEmpty()) {
+                finishFile();
+                return;
+            }
+            m_fileOutput = m_converter.isPassthrough() ? input : m_converter.convert(input);
+            continue;
+        }
+
+        // 按环形缓冲区剩余空间写入，预处理阶段消费后会再次唤醒
+        const qint64 chunk = qMin(qMin<qint64>(m_fileOutput.size(), m_ring->freeSpace()), allowed);
+        if (chunk <= 0) {
+            return;
+        }
+        m_ring->write(m_fileOutput.data(), chunk);
+        m_fileOutput = m_fileOutput.sliced(chunk);
+        m_fileWritten += chunk;
+        allowed -= chunk;
+    }
+}
+
+void AudioCaptureWorker::finishFile()
+{
+    qDebug() << "File data fully queued:" << m_fileWritten << "bytes";
+    // 先于结束标记发出，接收方总是在本会话的最终结果之前收到
+    emit fileFinished();
+    m_feedTimer->stop();
+    m_file.reset();
+    m_fileOutput = QByteArrayView();
+    m_ring->closeWriteChannel();
+}
@@ -0,0 +1,88 @@
+#ifndef AUDIOCAPTUREWORKER_H
+#define AUDIOCAPTUREWORKER_H
+
+#include "pipelineStage.h"
+#include "audioConverter.h"
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QStringList>
+
+#include <memory>
+
+class QAudioSource;
+class QIODevice;
+class QTimer;
+class AudioRingBuffer;
+class AudioFileSource;
+
+// 采集阶段：在独立线程中运行 QAudioSource，或从文件逐块读取数据写入环形缓冲区
+// 设备或文件不是 16k 单声道 Int16 时，数据先经 AudioConverter 转换再写入环形缓冲区；
+// 设备格式与目标一致时 QAudioSource 直接写入环形缓冲区，不经过转换。
+class AudioCaptureWorker : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    // 环形缓冲区作为本对象的子对象创建，与 QAudioSource 处于同一线程
+    explicit AudioCaptureWorker(qint64 ringCapacity, QObject *parent = nullptr);
+
+    AudioRingBuffer *ring() const { return m_ring; }
+
+public slots:
+    // 选择输入设备 (QAudioDevice::id()，为空时使用系统默认设备) 和声道 (-1 表示混音为单声道)，
+    // 已创建的 QAudioSource 会被释放，下次 initialize() 时按新设备重新创建
+    void setInput(const QByteArray &deviceId, int channel);
+
+    // 在采集线程中枚举设备、协商格式并创建 QAudioSource，完成后发出 initialized()
+    void initialize();
+    // 只枚举输入设备 (例如设备插拔后)，不影响正在使用的 QAudioSource
+    void enumerateDevices();
+
+    void startDevice();
+    // 按环形缓冲区的空闲空间逐块读取、转换并写入，文件不会整体读入内存；
+    // realTime 为 true 时按音频时长逐步写入，模拟实时采集
+    void startFile(std::shared_ptr<AudioFileSource> source, bool realTime);
+
+    // 停止采集并标记音频流结束
+    void stop();
+
+    // 停止采集，不标记流结束 (用于开始新会话前)
+    void reset();
+
+signals:
+    // 设备列表在采集线程中枚举，界面线程不必为此阻塞
+    void devicesEnumerated(const QStringList &names, const QList<QByteArray> &ids);
+    void initialized();
+    // 文件输入已全部写入环形缓冲区；被 stop() 提前停止时不发出
+    void fileFinished();
+
+protected:
+    // 环形缓冲区腾出空间后继续写入文件数据
+    void process() override;
+
+private:
+    void readDevice();
+    void finishFile();
+
+    AudioRingBuffer *m_ring;
+    QAudioSource *m_audioSource = nullptr;
+    QAudioFormat m_format;
+    QByteArray m_deviceId;
+    int m_channel = -1;
+
+    AudioConverter m_converter;
+    QIODevice *m_deviceIo = nullptr;  // 需要转换时 QAudioSource 提供的读取设备
+    QByteArray m_deviceBuffer;
+
+    std::shared_ptr<AudioFileSource> m_file;
+    QByteArrayView m_fileOutput;  // 已转换、尚未写入环形缓冲区的部分
+    qint64 m_fileWritten = 0;     // 已写入的 16k 单声道字节数
+    bool m_realTimeFeed = false;
+    QTimer *m_feedTimer = nullptr;
+    QElapsedTimer m_feedClock;
+};
+
+#endif // AUDIOCAPTUREWORKER_H
@@ -0,0 +1,231 @@
+#include "audioCodec.h"
+#include "iatProtocol.h"
+
+#ifdef HAVE_SPEEX
+#include <speex/speex.h>
+#endif
+
+#ifdef HAVE_LAME
+#include <lame/lame.h>
+#endif
+
+#include <cstring>
+
+namespace {
+// 不压缩：直接返回输入，不产生拷贝
+class RawCodec : public AudioCodec
+{
+public:
+    AudioEncoding encoding() const override { return AudioEncoding::Raw; }
+    void reset() override {}
+    QByteArrayView encode(QByteArrayView pcm, bool) override { return pcm; }
+    qsizetype maxEncodedSize(qsizetype pcmSize) const override { return pcmSize; }
+};
+
+#ifdef HAVE_SPEEX
+constexpr int SPEEX_QUALITY = 8;       // 宽带模式下 27.8 kbps，每 20ms 一包 70 字节
+constexpr int SPEEX_MAX_PACKET = 128;  // 宽带模式最高质量的单包长度也不超过 106 字节
+
+class SpeexWbCodec : public AudioCodec
+{
+public:
+    SpeexWbCodec()
+    {
+        m_state = speex_encoder_init(&speex_wb_mode);
+        int quality = SPEEX_QUALITY;
+        speex_encoder_ctl(m_state, SPEEX_SET_QUALITY, &quality);
+        speex_encoder_ctl(m_state, SPEEX_GET_FRAME_SIZE, &m_frameSamples);
+        speex_bits_init(&m_bits);
+        m_frame.resize(m_frameSamples * 2);
+    }
+
+    ~SpeexWbCodec() override
+    {
+        speex_bits_destroy(&m_bits);
+        speex_encoder_destroy(m_state);
+    }
+
+    AudioEncoding encoding() const override { return AudioEncoding::SpeexWb; }
+
+    void reset() override
+    {
+        speex_encoder_ctl(m_state, SPEEX_RESET_STATE, nullptr);
+        m_pendingBytes = 0;
+    }
+
+    QByteArrayView encode(QByteArrayView pcm, bool last) override
+    {
+        const qsizetype frameBytes = m_frame.size();
+        m_output.resize(maxEncodedSize(pcm.size()));
+        char *dst = m_output.data();
+
+        const char *src = pcm.data();
+        qsizetype remaining = pcm.size();
+        while (remaining > 0 || (last && m_pendingBytes > 0)) {
+            // 凑满一个编码帧；speex_encode_int() 会改写输入，因此总是先拷贝到 m_frame
+            const qsizetype take = qMin(remaining, frameBytes - m_pendingBytes);
+            memcpy(m_frame.data() + m_pendingBytes, src, take);
+            m_pendingBytes += take;
+            src += take;
+            remaining -= take;
+
+            if (m_pendingBytes < frameBytes) {
+                if (!last) {
+                    break;
+                }
+                memset(m_frame.data() + m_pendingBytes, 0, frameBytes - m_pendingBytes);
+            }
+
+            speex_bits_reset(&m_bits);
+            speex_encode_int(m_state, reinterpret_cast<spx_int16_t *>(m_frame.data()), &m_bits);
+            dst += speex_bits_write(&m_bits, dst, SPEEX_MAX_PACKET);
+            m_pendingBytes = 0;
+        }
+
+        return QByteArrayView(m_output.constData(), dst - m_output.constData());
+    }
+
+    qsizetype maxEncodedSize(qsizetype pcmSize) const override
+    {
+        const qsizetype frameBytes = m_frameSamples * 2;
+        return (pcmSize + m_pendingBytes + frameBytes - 1) / frameBytes * SPEEX_MAX_PACKET;
+    }
+
+private:
+    void *m_state = nullptr;
+    SpeexBits m_bits;
+    int m_frameSamples = 320;
+    QByteArray m_frame;           // 一个编码帧的 PCM
+    qsizetype m_pendingBytes = 0; // m_frame 中尚未编码的字节数
+    QByteArray m_output;          // 复用的输出缓冲区
+};
+#endif // HAVE_SPEEX
+
+#ifdef HAVE_LAME
+constexpr int LAME_BITRATE_KBPS = 32;
+constexpr int LAME_FLUSH_BYTES = 7200;  // lame_encode_flush() 最多输出的字节数
+
+class LameCodec : public AudioCodec
+{
+public:
+    LameCodec() { open(); }
+    ~LameCodec() override { lame_close(m_lame); }
+
+    AudioEncoding encoding() const override { return AudioEncoding::Lame; }
+
+    void reset() override
+    {
+        // lame 没有复位接口，重新初始化以丢弃上一个会话缓存的样本
+        lame_close(m_lame);
+        open();
+    }
+
+    QByteArrayView encode(QByteArrayView pcm, bool last) override
+    {
+        m_output.resize(maxEncodedSize(pcm.size()));
+        unsigned char *dst = reinterpret_cast<unsigned char *>(m_output.data());
+        const int capacity = int(m_output.size());
+
+        // 单声道时右声道参数被忽略
+        const short *samples = reinterpret_cast<const short *>(pcm.data());
+        int written = 0;
+        if (!pcm.isEmpty()) {
+            written = qMax(0, lame_encode_buffer(m_lame, samples, samples, int(pcm.size() / 2), dst, capacity));
+        }
+        if (last) {
+            written += qMax(0, lame_encode_flush(m_lame, dst + written, capacity - written));
+        }
+        return QByteArrayView(m_output.constData(), written);
+    }
+
+    qsizetype maxEncodedSize(qsizetype pcmSize) const override
+    {
+        // lame 文档给出的上界：1.25 * 样本数 + 7200
+        return pcmSize / 2 * 5 / 4 + LAME_FLUSH_BYTES;
+    }
+
+private:
+    void open()
+    {
+        m_lame = lame_init();
+        lame_set_in_samplerate(m_lame, SAMPLE_RATE);
+        lame_set_out_samplerate(m_lame, SAMPLE_RATE);
+        lame_set_num_channels(m_lame, 1);
+        lame_set_mode(m_lame, MONO);
+        lame_set_VBR(m_lame, vbr_off);
+        lame_set_brate(m_lame, LAME_BITRATE_KBPS);
+        lame_set_quality(m_lame, 5);
+        lame_init_params(m_lame);
+    }
+
+    lame_t m_lame = nullptr;
+    QByteArray m_output;
+};
+#endif // HAVE_LAME
+}
+
+QByteArray audioEncodingName(AudioEncoding encoding)
+{
+    switch (encoding) {
+    case AudioEncoding::Raw:
+        return "raw";
+    case AudioEncoding::SpeexWb:
+        return "speex-wb";
+    case AudioEncoding::Lame:
+        return "lame";
+    }
+    return "raw";
+}
+
+bool parseAudioEncoding(const QString &name, AudioEncoding *encoding)
+{
+    for (AudioEncoding candidate : { AudioEncoding::Raw, AudioEncoding::SpeexWb, AudioEncoding::Lame }) {
+        if (name == QString::fromLatin1(audioEncodingName(candidate))) {
+            *encoding = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool audioEncodingSupported(AudioEncoding encoding)
+{
+    switch (encoding) {
+    case AudioEncoding::Raw:
+        return true;
+    case AudioEncoding::SpeexWb:
+#ifdef HAVE_SPEEX
+        return true;
+#else
+        return false;
+#endif
+    case AudioEncoding::Lame:
+#ifdef HAVE_LAME
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+std::unique_ptr<AudioCodec> createAudioCodec(AudioEncoding encoding)
+{
+    switch (encoding) {
+    case AudioEncoding::Raw:
+        return std::make_unique<RawCodec>();
+    case AudioEncoding::SpeexWb:
+#ifdef HAVE_SPEEX
+        return std::make_unique<SpeexWbCodec>();
+#else
+        break;
+#endif
+    case AudioEncoding::Lame:
+#ifdef HAVE_LAME
+        return std::make_unique<LameCodec>();
+#else
+        break;
+#endif
+    }
+    return nullptr;
+}
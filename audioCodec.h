@@ -0,0 +1,46 @@
+#ifndef AUDIOCODEC_H
+#define AUDIOCODEC_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+#include <memory>
+
+// 上行音频编码，对应帧头 data.encoding 字段
+enum class AudioEncoding {
+    Raw,      // 16k 单声道 Int16 PCM，不压缩
+    SpeexWb,  // 开源 speex 宽带编码，质量 8，每 20ms 一包 70 字节 (business.speex_size)
+    Lame      // MP3 (MPEG-2 Layer III)，32 kbps CBR
+};
+
+// 帧头中的 encoding 值，同时用作命令行参数
+QByteArray audioEncodingName(AudioEncoding encoding);
+bool parseAudioEncoding(const QString &name, AudioEncoding *encoding);
+// speex/lame 只在构建时找到对应的库 (HAVE_SPEEX / HAVE_LAME) 时可用
+bool audioEncodingSupported(AudioEncoding encoding);
+
+// 帧编码阶段使用的音频编码器，只在编码阶段的线程中使用
+// 输入为预处理后的 16k 单声道 Int16 PCM，长度不必是编码帧长的整数倍，
+// 不足一个编码帧的尾部数据留到下一次调用，last 为 true 时补零并冲刷编码器。
+class AudioCodec
+{
+public:
+    virtual ~AudioCodec() = default;
+
+    virtual AudioEncoding encoding() const = 0;
+
+    // 新会话开始前清空编码器状态和未编码的尾部数据
+    virtual void reset() = 0;
+
+    // 返回本次编码输出，视图在下一次调用 encode() 或 reset() 之前有效
+    virtual QByteArrayView encode(QByteArrayView pcm, bool last) = 0;
+
+    // 输入 pcmSize 字节时输出长度的上界，用于预分配消息缓冲区
+    virtual qsizetype maxEncodedSize(qsizetype pcmSize) const = 0;
+};
+
+// 构建时未包含的编码返回 nullptr
+std::unique_ptr<AudioCodec> createAudioCodec(AudioEncoding encoding);
+
+#endif // AUDIOCODEC_H
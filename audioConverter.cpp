@@ -0,0 +1,196 @@
+#include "audioConverter.h"
+#include "audioKernels.h"
+#include "iatProtocol.h"
+
+#include <QDebug>
+
+namespace {
+// 各样本格式到 [-1, 1) 浮点的映射
+template <QAudioFormat::SampleFormat Format>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<QAudioFormat::UInt8>
+{
+    using Type = quint8;
+    static float toFloat(Type value) { return (int(value) - 128) * (1.0f / 128); }
+};
+
+template <>
+struct SampleTraits<QAudioFormat::Int16>
+{
+    using Type = qint16;
+    static float toFloat(Type value) { return value * (1.0f / 32768); }
+};
+
+template <>
+struct SampleTraits<QAudioFormat::Int32>
+{
+    using Type = qint32;
+    static float toFloat(Type value) { return value * (1.0f / 2147483648.0f); }
+};
+
+template <>
+struct SampleTraits<QAudioFormat::Float>
+{
+    using Type = float;
+    static float toFloat(Type value) { return value; }
+};
+
+// Channels 为 0 表示声道数在运行时给出；1、2 声道在编译期展开内层循环
+template <QAudioFormat::SampleFormat Format, int Channels>
+void decodeToMono(const char *src, qsizetype frames, int channels, float *dst)
+{
+    using Traits = SampleTraits<Format>;
+    const auto *in = reinterpret_cast<const typename Traits::Type *>(src);
+    const int count = Channels > 0 ? Channels : channels;
+    const float scale = 1.0f / count;
+
+    for (qsizetype i = 0; i < frames; ++i) {
+        float sum = 0.0f;
+        for (int c = 0; c < count; ++c) {
+            sum += Traits::toFloat(in[c]);
+        }
+        dst[i] = sum * scale;
+        in += count;
+    }
+}
+
+// 只取一个声道：src 已偏移到该声道的第一个样本，按声道数跨步读取
+template <QAudioFormat::SampleFormat Format>
+void decodeChannel(const char *src, qsizetype frames, int channels, float *dst)
+{
+    using Traits = SampleTraits<Format>;
+    const auto *in = reinterpret_cast<const typename Traits::Type *>(src);
+
+    for (qsizetype i = 0; i < frames; ++i) {
+        dst[i] = Traits::toFloat(*in);
+        in += channels;
+    }
+}
+
+template <QAudioFormat::SampleFormat Format>
+AudioConverter::DecodeFunction decoderFor(int channels, int channel)
+{
+    if (channel >= 0 && channels > 1) {
+        return decodeChannel<Format>;
+    }
+
+    switch (channels) {
+    case 1:
+        return decodeToMono<Format, 1>;
+    case 2:
+        return decodeToMono<Format, 2>;
+    default:
+        return decodeToMono<Format, 0>;
+    }
+}
+}
+
+AudioConverter::AudioConverter()
+{
+    m_format = outputFormat();
+}
+
+QAudioFormat AudioConverter::outputFormat()
+{
+    QAudioFormat format;
+    format.setSampleRate(SAMPLE_RATE);
+    format.setChannelCount(1);
+    format.setSampleFormat(QAudioFormat::Int16);
+    return format;
+}
+
+bool AudioConverter::setInputFormat(const QAudioFormat &format, int channel)
+{
+    m_format = outputFormat();
+    m_decode = nullptr;
+    m_channelOffset = 0;
+
+    if (format == outputFormat()) {
+        reset();
+        return true;
+    }
+
+    const int channels = format.channelCount();
+    if (channels <= 0 || format.sampleRate() <= 0) {
+        qWarning() << "Unsupported audio format for conversion:" << format;
+        return false;
+    }
+    if (channel >= channels) {
+        qWarning() << "Input has" << channels << "channel(s), cannot select channel" << channel << "- mixing instead";
+        channel = -1;
+    }
+
+    switch (format.sampleFormat()) {
+    case QAudioFormat::UInt8:
+        m_decode = decoderFor<QAudioFormat::UInt8>(channels, channel);
+        break;
+    case QAudioFormat::Int16:
+        m_decode = decoderFor<QAudioFormat::Int16>(channels, channel);
+        break;
+    case QAudioFormat::Int32:
+        m_decode = decoderFor<QAudioFormat::Int32>(channels, channel);
+        break;
+    case QAudioFormat::Float:
+        m_decode = decoderFor<QAudioFormat::Float>(channels, channel);
+        break;
+    default:
+        qWarning() << "Unsupported sample format for conversion:" << format.sampleFormat();
+        return false;
+    }
+
+    m_format = format;
+    if (channel >= 0 && channels > 1) {
+        m_channelOffset = channel * format.bytesPerSample();
+    }
+    m_resampler.configure(format.sampleRate(), SAMPLE_RATE);
+    reset();
+
+    qDebug() << "Converting audio from" << format.sampleRate() << "Hz"
+             << format.channelCount() << "channel(s)" << format.sampleFormat()
+             << (channel >= 0 && channels > 1 ? QString("(channel %1)").arg(channel) : QString("(mixed)"))
+             << "to 16 kHz mono Int16";
+    return true;
+}
+
+void AudioConverter::reset()
+{
+    m_resampler.reset();
+    m_pending.clear();
+}
+
+QByteArrayView AudioConverter::convert(QByteArrayView input)
+{
+    if (isPassthrough()) {
+        return input;
+    }
+
+    // 拼接上次剩余的不完整采样帧
+    QByteArrayView data = input;
+    if (!m_pending.isEmpty()) {
+        m_pending.append(input);
+        data = m_pending;
+    }
+
+    const int frameBytes = m_format.bytesPerFrame();
+    const qsizetype frames = data.size() / frameBytes;
+
+    m_mono.resize(frames);
+    m_decode(data.data() + m_channelOffset, frames, m_format.channelCount(), m_mono.data());
+
+    // data 可能指向 m_pending 本身，先复制剩余部分再替换
+    const qsizetype restSize = data.size() - frames * frameBytes;
+    m_pending = restSize > 0 ? data.last(restSize).toByteArray() : QByteArray();
+
+    const QList<float> *samples = &m_mono;
+    if (!m_resampler.isPassthrough()) {
+        m_resampled.clear();
+        m_resampler.process(m_mono.constData(), m_mono.size(), m_resampled);
+        samples = &m_resampled;
+    }
+
+    m_output.resize(samples->size() * 2);
+    audioFloatToInt16(samples->constData(), samples->size(), reinterpret_cast<qint16 *>(m_output.data()));
+    return m_output;
+}
@@ -0,0 +1,49 @@
+#ifndef AUDIOCONVERTER_H
+#define AUDIOCONVERTER_H
+
+#include "polyphaseResampler.h"
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+
+// 把任意采样率/声道数/样本格式的 PCM 转换为接口要求的 16k 单声道 Int16
+// 流程：解码并混音 (或选取一个声道) 为单声道浮点 → 多相重采样 → 饱和转换为 Int16。
+// 解码函数按 (样本格式, 声道数) 在编译期实例化，setInputFormat() 时选定，
+// 逐样本循环中没有格式或声道判断。输入已是目标格式时直接透传。
+class AudioConverter
+{
+public:
+    AudioConverter();
+
+    // 设置输入格式并清空内部状态，不支持的格式返回 false 且保持透传；
+    // channel >= 0 时只取多声道输入中的该声道 (例如麦克风阵列的一路)，否则混音为单声道
+    bool setInputFormat(const QAudioFormat &format, int channel = -1);
+    QAudioFormat inputFormat() const { return m_format; }
+    bool isPassthrough() const { return m_decode == nullptr; }
+
+    // 清空重采样历史和不完整的输入帧，开始新的音频流前调用
+    void reset();
+
+    // 转换任意长度的输入，返回的视图在下次调用前有效；
+    // 末尾不足一个采样帧的字节保留到下次调用
+    QByteArrayView convert(QByteArrayView input);
+
+    static QAudioFormat outputFormat();
+
+    using DecodeFunction = void (*)(const char *src, qsizetype frames, int channels, float *dst);
+
+private:
+    QAudioFormat m_format;
+    DecodeFunction m_decode = nullptr;
+    qsizetype m_channelOffset = 0;  // 选定声道在每个采样帧中的字节偏移
+    PolyphaseResampler m_resampler;
+
+    QByteArray m_pending;  // 上次剩余的不完整采样帧
+    QList<float> m_mono;
+    QList<float> m_resampled;
+    QByteArray m_output;
+};
+
+#endif // AUDIOCONVERTER_H
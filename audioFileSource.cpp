@@ -0,0 +1,197 @@
+#include "audioFileSource.h"
+
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+// WAV fmt 块中的编码类型
+constexpr quint16 WAVE_FORMAT_PCM = 1;
+constexpr quint16 WAVE_FORMAT_IEEE_FLOAT = 3;
+constexpr quint16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+}
+
+AudioFileSource::~AudioFileSource()
+{
+    close();
+}
+
+bool AudioFileSource::open(const QString &path, const QAudioFormat &rawFormat, QString *error)
+{
+    close();
+
+    QString reason;
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        reason = m_file.errorString();
+    } else if (path.endsWith(".wav", Qt::CaseInsensitive)) {
+        parseWav(&reason);
+    } else if (!rawFormat.isValid()) {
+        reason = "invalid raw PCM format";
+    } else {
+        m_format = rawFormat;
+        m_dataOffset = 0;
+        m_size = m_file.size();
+    }
+
+    if (!reason.isEmpty()) {
+        if (error) {
+            *error = reason;
+        }
+        close();
+        return false;
+    }
+
+    // 不足一个采样帧的尾部字节不属于有效音频
+    m_size -= m_size % m_format.bytesPerFrame();
+    m_position = 0;
+
+    if (m_size > 0) {
+        m_map = m_file.map(m_dataOffset, m_size);
+    }
+    if (!m_map) {
+        m_file.seek(m_dataOffset);
+    }
+    qDebug() << "Opened audio file" << path << "bytes:" << m_size
+             << (m_map ? "(memory mapped)" : "(chunked reads)");
+    return true;
+}
+
+void AudioFileSource::openData(const QByteArray &data, const QAudioFormat &format)
+{
+    close();
+    m_data = data;
+    m_format = format;
+    m_size = data.size() - data.size() % qMax(1, format.bytesPerFrame());
+    m_position = 0;
+}
+
+void AudioFileSource::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_data.clear();
+    m_chunk.clear();
+    m_format = QAudioFormat();
+    m_dataOffset = 0;
+    m_size = -1;
+    m_position = 0;
+}
+
+double AudioFileSource::durationSecs() const
+{
+    if (m_size <= 0 || !m_format.isValid()) {
+        return 0.0;
+    }
+    return double(m_size) / m_format.bytesPerFrame() / m_format.sampleRate();
+}
+
+void AudioFileSource::rewind()
+{
+    m_position = 0;
+    if (m_data.isNull() && !m_map && m_file.isOpen()) {
+        m_file.seek(m_dataOffset);
+    }
+}
+
+QByteArrayView AudioFileSource::read(qint64 maxSize)
+{
+    const qint64 frameBytes = m_format.bytesPerFrame();
+    const qint64 size = qMin(maxSize, m_size - m_position) / frameBytes * frameBytes;
+    if (size <= 0) {
+        return QByteArrayView();
+    }
+
+    const char *data = nullptr;
+    if (!m_data.isNull()) {
+        data = m_data.constData() + m_position;
+    } else if (m_map) {
+        data = reinterpret_cast<const char *>(m_map) + m_position;
+    } else {
+        m_chunk.resize(size);
+        const qint64 read = m_file.read(m_chunk.data(), size);
+        if (read != size) {
+            // 文件被截断或读取出错，按已读到的位置结束
+            qWarning() << "Audio file read failed:" << m_file.errorString();
+            m_size = m_position;
+            return QByteArrayView();
+        }
+        data = m_chunk.constData();
+    }
+
+    m_position += size;
+    return QByteArrayView(data, size);
+}
+
+bool AudioFileSource::parseWav(QString *error)
+{
+    // 只读取各个块的头部，跳过的块直接 seek，不把文件读入内存
+    const QByteArray riff = m_file.read(12);
+    if (riff.size() < 12 || !riff.startsWith("RIFF") || riff.mid(8, 4) != "WAVE") {
+        *error = "not a RIFF/WAVE file";
+        return false;
+    }
+
+    const qint64 fileSize = m_file.size();
+    bool haveFormat = false;
+    qint64 offset = 12;
+    while (offset + 8 <= fileSize) {
+        m_file.seek(offset);
+        const QByteArray header = m_file.read(8);
+        if (header.size() < 8) {
+            break;
+        }
+        const QByteArray id = header.left(4);
+        const qint64 size = qFromLittleEndian<quint32>(header.constData() + 4);
+        const qint64 body = offset + 8;
+
+        if (id == "fmt " && size >= 16) {
+            const QByteArray fmt = m_file.read(qMin<qint64>(size, 26));
+            if (fmt.size() < 16) {
+                break;
+            }
+            quint16 encoding = qFromLittleEndian<quint16>(fmt.constData());
+            const int channels = qFromLittleEndian<quint16>(fmt.constData() + 2);
+            const int sampleRate = qFromLittleEndian<quint32>(fmt.constData() + 4);
+            const int bits = qFromLittleEndian<quint16>(fmt.constData() + 14);
+            if (encoding == WAVE_FORMAT_EXTENSIBLE && fmt.size() >= 26) {
+                encoding = qFromLittleEndian<quint16>(fmt.constData() + 24);  // 子格式 GUID 的前两个字节
+            }
+
+            QAudioFormat::SampleFormat sampleFormat = QAudioFormat::Unknown;
+            if (encoding == WAVE_FORMAT_PCM) {
+                sampleFormat = bits == 8 ? QAudioFormat::UInt8
+                             : bits == 16 ? QAudioFormat::Int16
+                             : bits == 32 ? QAudioFormat::Int32
+                                          : QAudioFormat::Unknown;
+            } else if (encoding == WAVE_FORMAT_IEEE_FLOAT && bits == 32) {
+                sampleFormat = QAudioFormat::Float;
+            }
+            if (sampleFormat == QAudioFormat::Unknown || channels <= 0 || sampleRate <= 0) {
+                *error = QString("unsupported WAV encoding %1 with %2 bits").arg(encoding).arg(bits);
+                return false;
+            }
+
+            m_format.setSampleRate(sampleRate);
+            m_format.setChannelCount(channels);
+            m_format.setSampleFormat(sampleFormat);
+            haveFormat = true;
+        } else if (id == "data") {
+            if (!haveFormat) {
+                *error = "data chunk before fmt chunk";
+                return false;
+            }
+            // 录音中断的文件 data 长度可能不准确，以实际文件长度为准
+            m_dataOffset = body;
+            m_size = qMin(size, fileSize - body);
+            return true;
+        }
+
+        offset = body + size + (size & 1);  // 块按偶数字节对齐
+    }
+
+    *error = "no data chunk";
+    return false;
+}
@@ -0,0 +1,58 @@
+#ifndef AUDIOFILESOURCE_H
+#define AUDIOFILESOURCE_H
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+
+// 按块读取的音频文件：.wav 解析 RIFF 文件头得到格式，其他文件按调用方给定的格式视为裸 PCM。
+// 音频数据优先内存映射，映射失败时退回到固定大小的分块读取，
+// 两种方式的内存占用都与文件长度无关，数小时的录音也不会整体读入内存。
+// 在哪个线程 open() 都可以，之后只能由一个线程调用 read()。
+class AudioFileSource
+{
+public:
+    AudioFileSource() = default;
+    ~AudioFileSource();
+
+    AudioFileSource(const AudioFileSource &) = delete;
+    AudioFileSource &operator=(const AudioFileSource &) = delete;
+
+    // rawFormat 只用于非 WAV 文件；失败时返回 false 并写明原因
+    bool open(const QString &path, const QAudioFormat &rawFormat, QString *error = nullptr);
+    // 直接使用内存中的裸 PCM，不拷贝数据 (QByteArray 隐式共享)
+    void openData(const QByteArray &data, const QAudioFormat &format);
+    void close();
+
+    bool isOpen() const { return m_size >= 0; }
+    bool isMapped() const { return m_map != nullptr; }
+    QString path() const { return m_file.fileName(); }
+    QAudioFormat format() const { return m_format; }
+
+    // 音频数据的字节数和时长，不含文件头
+    qint64 size() const { return m_size; }
+    double durationSecs() const;
+
+    // 返回接下来最多 maxSize 字节 (按采样帧对齐) 的音频，视图在下次 read() 或 close() 前有效；
+    // 读完或出错时返回空视图
+    QByteArrayView read(qint64 maxSize);
+    bool atEnd() const { return m_position >= m_size; }
+    // 回到音频数据开头，例如先计算整段音频的缓存键再交给流水线读取
+    void rewind();
+
+private:
+    bool parseWav(QString *error);
+
+    QFile m_file;
+    QByteArray m_data;      // openData() 的数据
+    uchar *m_map = nullptr;
+    QByteArray m_chunk;     // 无法映射时的分块读取缓冲区
+    QAudioFormat m_format;
+    qint64 m_dataOffset = 0;  // 音频数据在文件中的起始位置
+    qint64 m_size = -1;
+    qint64 m_position = 0;
+};
+
+#endif // AUDIOFILESOURCE_H
@@ -0,0 +1,143 @@
+#include "audioKernels.h"
+
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+quint64 audioSumOfSquares(const qint16 *samples, qsizetype count)
+{
+    quint64 sum = 0;
+    qsizetype i = 0;
+
+#ifdef __SSE2__
+    // pmaddwd 得到相邻两个样本的平方和，最大 2 * 32768^2 = 2^31，
+    // 按无符号 32 位解释不会溢出，再扩展到 64 位累加
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + i));
+        const __m128i squares = _mm_madd_epi16(v, v);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(squares, zero));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(squares, zero));
+    }
+    alignas(16) quint64 lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    sum = lanes[0] + lanes[1];
+#endif
+
+    for (; i < count; ++i) {
+        sum += quint64(qint32(samples[i]) * samples[i]);
+    }
+    return sum;
+}
+
+qsizetype audioZeroCrossings(const qint16 *samples, qsizetype count)
+{
+    qsizetype crossings = 0;
+    qsizetype i = 1;
+
+#ifdef __SSE2__
+    // 当前样本与前一样本异或后符号位为 1 即发生过零，算术右移得到 0/-1 掩码，
+    // 再用 pmaddwd 两两求和扩展到 32 位，避免 16 位计数溢出
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + i));
+        const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + i - 1));
+        const __m128i mask = _mm_srai_epi16(_mm_xor_si128(current, previous), 15);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(mask, ones));
+    }
+    alignas(16) qint32 lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    crossings = -(qsizetype(lanes[0]) + lanes[1] + lanes[2] + lanes[3]);
+#endif
+
+    for (; i < count; ++i) {
+        crossings += (samples[i] ^ samples[i - 1]) < 0;
+    }
+    return crossings;
+}
+
+int audioPeakAmplitude(const qint16 *samples, qsizetype count)
+{
+    int maxSample = 0;
+    int minSample = 0;
+    qsizetype i = 0;
+
+#ifdef __SSE2__
+    // 分别求最大值和最小值，避免 -32768 取绝对值溢出
+    __m128i maxAcc = _mm_setzero_si128();
+    __m128i minAcc = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + i));
+        maxAcc = _mm_max_epi16(maxAcc, v);
+        minAcc = _mm_min_epi16(minAcc, v);
+    }
+    alignas(16) qint16 maxLanes[8];
+    alignas(16) qint16 minLanes[8];
+    _mm_store_si128(reinterpret_cast<__m128i *>(maxLanes), maxAcc);
+    _mm_store_si128(reinterpret_cast<__m128i *>(minLanes), minAcc);
+    for (int lane = 0; lane < 8; ++lane) {
+        maxSample = qMax<int>(maxSample, maxLanes[lane]);
+        minSample = qMin<int>(minSample, minLanes[lane]);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        maxSample = qMax<int>(maxSample, samples[i]);
+        minSample = qMin<int>(minSample, samples[i]);
+    }
+    return qMax(maxSample, -minSample);
+}
+
+float audioDotProduct(const float *a, const float *b, qsizetype count)
+{
+    float sum = 0.0f;
+    qsizetype i = 0;
+
+#ifdef __SSE2__
+    // 两组累加器交替使用，缩短加法的依赖链
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void audioFloatToInt16(const float *samples, qsizetype count, qint16 *output)
+{
+    qsizetype i = 0;
+
+#ifdef __SSE2__
+    // cvtps 按当前舍入模式 (默认就近取偶) 取整，packs 负责饱和；
+    // 先限幅到 int32 可表示的范围，避免溢出为 0x80000000
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 limit = _mm_set1_ps(65536.0f);
+    const __m128 negativeLimit = _mm_set1_ps(-65536.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m128 lo = _mm_mul_ps(_mm_loadu_ps(samples + i), scale);
+        __m128 hi = _mm_mul_ps(_mm_loadu_ps(samples + i + 4), scale);
+        lo = _mm_max_ps(_mm_min_ps(lo, limit), negativeLimit);
+        hi = _mm_max_ps(_mm_min_ps(hi, limit), negativeLimit);
+        const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), packed);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const float value = std::nearbyint(samples[i] * 32768.0f);
+        output[i] = qint16(qBound(-32768.0f, value, 32767.0f));
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef AUDIOKERNELS_H
+#define AUDIOKERNELS_H
+
+#include <QtGlobal>
+
+// 音频处理的基础向量运算：16 位 PCM 的统计量供语音活动检测和电平表使用，
+// 浮点点积和定点转换供格式转换/重采样使用
+// x86 上使用 SSE2 (x86-64 的基线指令集，无需运行时检测)，其余平台使用标量实现。
+
+// 样本平方和，count 个样本的结果不会溢出 64 位
+quint64 audioSumOfSquares(const qint16 *samples, qsizetype count);
+
+// 相邻样本符号变化的次数 (0 视为正数)，结果范围 [0, count - 1]
+qsizetype audioZeroCrossings(const qint16 *samples, qsizetype count);
+
+// 样本绝对值的最大值，范围 [0, 32768]
+int audioPeakAmplitude(const qint16 *samples, qsizetype count);
+
+// 两个浮点数组的点积
+float audioDotProduct(const float *a, const float *b, qsizetype count);
+
+// [-1, 1) 浮点样本转换为 16 位整数，四舍五入并饱和到 [-32768, 32767]
+void audioFloatToInt16(const float *samples, qsizetype count, qint16 *output);
+
+#endif // AUDIOKERNELS_H
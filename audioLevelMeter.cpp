@@ -0,0 +1,98 @@
+#include "audioLevelMeter.h"
+#include "audioKernels.h"
+#include "iatProtocol.h"
+
+#include <cmath>
+
+AudioLevelMeter::AudioLevelMeter(int windowMs, int blockMs)
+    : m_blockSamples(qMax<qsizetype>(1, qsizetype(blockMs) * SAMPLE_RATE / 1000))
+{
+    const int blockCount = qMax(1, windowMs / qMax(1, blockMs));
+    m_blockEnergy.resize(blockCount);
+    m_blockPeak.resize(blockCount);
+    reset();
+}
+
+void AudioLevelMeter::reset()
+{
+    m_blockEnergy.fill(0);
+    m_blockPeak.fill(0);
+    m_nextBlock = 0;
+    m_filledBlocks = 0;
+    m_windowEnergy = 0;
+    m_currentEnergy = 0;
+    m_currentPeak = 0;
+    m_currentSamples = 0;
+}
+
+void AudioLevelMeter::process(QByteArrayView pcm)
+{
+    const qint16 *samples = reinterpret_cast<const qint16 *>(pcm.data());
+    qsizetype remaining = pcm.size() / 2;
+
+    while (remaining > 0) {
+        const qsizetype count = qMin(remaining, m_blockSamples - m_currentSamples);
+        m_currentEnergy += audioSumOfSquares(samples, count);
+        m_currentPeak = qMax(m_currentPeak, audioPeakAmplitude(samples, count));
+        m_currentSamples += count;
+        samples += count;
+        remaining -= count;
+
+        if (m_currentSamples == m_blockSamples) {
+            commitBlock();
+        }
+    }
+}
+
+void AudioLevelMeter::commitBlock()
+{
+    // 用新块替换窗口中最旧的块，平方和增量更新
+    m_windowEnergy -= m_blockEnergy[m_nextBlock];
+    m_windowEnergy += m_currentEnergy;
+    m_blockEnergy[m_nextBlock] = m_currentEnergy;
+    m_blockPeak[m_nextBlock] = m_currentPeak;
+
+    m_nextBlock = (m_nextBlock + 1) % m_blockEnergy.size();
+    m_filledBlocks = qMin<int>(m_filledBlocks + 1, m_blockEnergy.size());
+
+    m_currentEnergy = 0;
+    m_currentPeak = 0;
+    m_currentSamples = 0;
+}
+
+double AudioLevelMeter::rms() const
+{
+    if (m_filledBlocks == 0) {
+        return 0.0;
+    }
+    return std::sqrt(double(m_windowEnergy) / (qint64(m_filledBlocks) * m_blockSamples));
+}
+
+int AudioLevelMeter::peak() const
+{
+    // 窗口只有几十个块，直接取最大值
+    int peak = 0;
+    for (int i = 0; i < m_filledBlocks; ++i) {
+        peak = qMax(peak, m_blockPeak[i]);
+    }
+    return peak;
+}
+
+double AudioLevelMeter::rmsDb() const
+{
+    return toDb(rms());
+}
+
+double AudioLevelMeter::peakDb() const
+{
+    return toDb(peak());
+}
+
+double AudioLevelMeter::toDb(double amplitude)
+{
+    // 参考值：16位音频的最大值是32768
+    if (amplitude <= 0) {
+        return MIN_DB;
+    }
+    return qMax(MIN_DB, 20 * std::log10(amplitude / 32768.0));
+}
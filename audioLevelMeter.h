@@ -0,0 +1,48 @@
+#ifndef AUDIOLEVELMETER_H
+#define AUDIOLEVELMETER_H
+
+#include <QByteArrayView>
+#include <QList>
+#include <QtGlobal>
+
+// 滑动窗口电平表：音频按固定长度的块累计平方和与峰值，
+// 窗口内各块的统计量保存在环形数组中，新块进入时减去最旧块、加上新块，
+// 每个样本只处理一次，查询开销与录音时长无关。
+class AudioLevelMeter
+{
+public:
+    static constexpr double MIN_DB = -90.0;  // 静音时报告的电平下限
+
+    explicit AudioLevelMeter(int windowMs = 300, int blockMs = 10);
+
+    void reset();
+
+    // 输入 16k/16bit 单声道音频，长度任意 (需为整数个样本)
+    void process(QByteArrayView pcm);
+
+    // 最近一个窗口的统计量，窗口未满时只统计已有部分
+    double rms() const;
+    int peak() const;
+    double rmsDb() const;
+    double peakDb() const;
+
+    static double toDb(double amplitude);
+
+private:
+    void commitBlock();
+
+    qsizetype m_blockSamples;
+
+    QList<quint64> m_blockEnergy;  // 窗口内各块的平方和
+    QList<int> m_blockPeak;
+    int m_nextBlock = 0;
+    int m_filledBlocks = 0;
+    quint64 m_windowEnergy = 0;
+
+    // 尚未凑满一块的部分
+    quint64 m_currentEnergy = 0;
+    int m_currentPeak = 0;
+    qsizetype m_currentSamples = 0;
+};
+
+#endif // AUDIOLEVELMETER_H
@@ -0,0 +1,367 @@
+#include "audioPreprocessor.h"
+#include "audioRingBuffer.h"
+#include "audioArchiver.h"
+#include "pipelineMetrics.h"
+
+#include <QDebug>
+#include <QString>
+
+#include <cstring>
+
+namespace {
+constexpr int MONITOR_ANALYSIS_BYTES = 100 * BYTES_PER_MS;  // 每100ms音频输出一次电平
+constexpr int LEVEL_PUBLISH_BYTES = 50 * BYTES_PER_MS;  // 电平通知间隔，约 20 次/秒
+}
+
+AudioPreprocessor::AudioPreprocessor(AudioRingBuffer *ring, SpscQueue<AudioFrame> *output, QObject *parent)
+    : PipelineStage(parent)
+    , m_ring(ring)
+    , m_output(output)
+{
+}
+
+void AudioPreprocessor::reset(AudioPreprocessor::Mode mode)
+{
+    m_ring->clear();
+    m_mode = mode;
+    m_finished = false;
+    m_monitorRecording.clear();
+    m_analyzedSize = 0;
+
+    m_meter.reset();
+    m_meteredBytes = 0;
+    m_unpublishedBytes = 0;
+
+    m_vad.setConfig(m_vadConfig);
+    m_padding.clear();
+    updatePaddingLimit();
+    m_framesAnalyzed = 0;
+    m_framesDropped = 0;
+
+    m_segmentBytes = 0;
+    m_segmentIndex = 0;
+    m_recentAudio.clear();
+    m_overlapPending = false;
+
+    m_utteranceActive = false;
+    m_silentBytes = 0;
+
+    if (m_archiver) {
+        m_archiver->beginSession(m_archiveDirectory);
+    }
+}
+
+void AudioPreprocessor::setFrameDuration(int msecs)
+{
+    const qint64 frameBytes = qint64(boundFrameMs(msecs)) * BYTES_PER_MS;
+    if (frameBytes == m_frameBytes) {
+        return;
+    }
+    qDebug() << "Frame duration" << m_frameBytes / BYTES_PER_MS << "->" << frameBytes / BYTES_PER_MS << "ms";
+    m_frameBytes = frameBytes;
+    updatePaddingLimit();
+}
+
+void AudioPreprocessor::updatePaddingLimit()
+{
+    // 缓存的静音帧、分段重叠帧和当前帧要能一次放进输出队列
+    m_maxPaddingFrames = qMin<int>(m_vad.paddingFrames(m_frameBytes), int(m_output->capacity()) - 2);
+    while (m_padding.size() > m_maxPaddingFrames) {
+        m_padding.removeFirst();
+        ++m_framesDropped;
+        if (m_metrics) {
+            m_metrics->add(PipelineMetrics::FramesSilent);
+        }
+    }
+}
+
+void AudioPreprocessor::process()
+{
+    if (m_finished) {
+        return;
+    }
+
+    // 先让新到达的音频经过电平表，再切帧
+    meterInput(m_ring->bytesAvailable());
+    publishLevel();
+
+    if (m_mode == MonitorMode) {
+        processMonitor();
+        return;
+    }
+
+    bool produced = false;
+    bool consumed = false;
+
+    // 输出队列放不下缓存的静音帧、重叠帧加当前帧时停止切帧，编码阶段取走数据后会再次唤醒
+    while (m_output->freeSlots() > size_t(m_padding.size()) + (m_overlapPending ? 1 : 0)) {
+        // 先读结束标志再读数据量，保证看到结束标志时数据已全部写入
+        const bool closed = m_ring->isWriteChannelClosed();
+        const qint64 availableData = m_ring->bytesAvailable();
+
+        if (availableData >= m_frameBytes) {
+            const QByteArrayView frame = m_ring->readSpan(m_frameBytes);
+            ++m_framesAnalyzed;
+            if (m_metrics) {
+                m_metrics->add(PipelineMetrics::FramesCaptured);
+            }
+            if (m_vad.analyzeFrame(frame)) {
+                if (m_mode == ListenMode && !m_utteranceActive) {
+                    qDebug() << "Speech started, sending" << m_padding.size() << "pre-roll frames";
+                    m_utteranceActive = true;
+                    emit utteranceStarted();
+                }
+                m_silentBytes = 0;
+
+                // 强制切分后的新一段先重发上一段末尾的音频，切分处的词完整地落在新一段里
+                if (m_overlapPending) {
+                    AudioFrame overlapFrame;
+                    overlapFrame.pcm = m_recentAudio;
+                    overlapFrame.overlap = true;
+                    emitFrame(std::move(overlapFrame));
+                    m_overlapPending = false;
+                }
+
+                // 检测到语音：先补发语音开始前缓存的静音帧
+                for (QByteArray &padding : m_padding) {
+                    AudioFrame paddingFrame;
+                    paddingFrame.pcm = std::move(padding);
+                    emitFrame(std::move(paddingFrame));
+                }
+                m_padding.clear();
+
+                AudioFrame audioFrame;
+                audioFrame.pcm = frame.toByteArray();
+                audioFrame.capturedAtNs = PipelineMetrics::now();
+                if (m_segmentBytes + frame.size() >= qint64(SEGMENT_HARD_LIMIT_MS) * BYTES_PER_MS) {
+                    // 到达上限仍没有停顿：在这一帧之后强制切分
+                    audioFrame.segmentEnd = true;
+                    m_overlapPending = true;
+                }
+                emitFrame(std::move(audioFrame));
+                produced = true;
+            } else {
+                // 强制切分后紧跟着停顿，说明切分处的词已在上一段内说完，不再重叠
+                m_overlapPending = false;
+
+                if (m_utteranceActive) {
+                    m_silentBytes += frame.size();
+                    if (m_silentBytes >= qint64(m_vadConfig.utteranceEndMs) * BYTES_PER_MS) {
+                        // 一句话结束：本段以结束帧收尾，网络阶段释放连接，直到下一句开始
+                        endUtterance(true);
+                        produced = true;
+                    }
+                }
+                if (m_segmentBytes >= qint64(SEGMENT_SOFT_LIMIT_MS) * BYTES_PER_MS) {
+                    // 接近时长上限时遇到停顿：在这里切分，停顿本身留作下一段的词首缓存
+                    AudioFrame endFrame;
+                    endFrame.segmentEnd = true;
+                    endFrame.capturedAtNs = PipelineMetrics::now();
+                    emitFrame(std::move(endFrame));
+                    produced = true;
+                }
+                holdPaddingFrame(frame);
+            }
+            consumeInput(frame.size());
+            consumed = true;
+            continue;
+        }
+
+        if (closed) {
+            // 音频流结束：剩余数据作为最后一帧，尾部缓存的静音帧不再发送
+            if (m_overlapPending && availableData > 0) {
+                AudioFrame overlapFrame;
+                overlapFrame.pcm = m_recentAudio;
+                overlapFrame.overlap = true;
+                emitFrame(std::move(overlapFrame));
+                m_overlapPending = false;
+            }
+
+            // 听音模式下停止时没有正在说的话：剩余音频同样是静音，只发出空的结束标记
+            AudioFrame lastFrame;
+            if (m_mode != ListenMode || m_utteranceActive) {
+                lastFrame.pcm = m_ring->readSpan(availableData).toByteArray();
+            }
+            lastFrame.last = true;
+            lastFrame.capturedAtNs = PipelineMetrics::now();
+            consumeInput(availableData);
+            emitFrame(std::move(lastFrame));
+            if (m_utteranceActive) {
+                endUtterance(false);
+            }
+            m_framesDropped += m_padding.size();
+            if (m_metrics) {
+                m_metrics->add(PipelineMetrics::FramesSilent, m_padding.size());
+            }
+            qDebug() << "Audio stream finished, last frame size:" << availableData
+                     << "dropped on overflow:" << m_ring->overflowBytes()
+                     << "silent frames skipped:" << m_framesDropped << "of" << m_framesAnalyzed
+                     << "segments:" << m_segmentIndex + 1;
+            m_padding.clear();
+            finishStream();
+            produced = true;
+            consumed = true;
+        }
+        break;
+    }
+
+    if (produced && m_downstream) {
+        m_downstream->wake();
+    }
+    if (consumed && m_upstream) {
+        m_upstream->wake();
+    }
+}
+
+void AudioPreprocessor::processMonitor()
+{
+    const bool closed = m_ring->isWriteChannelClosed();
+
+    // 测试时长固定为5秒，将环形缓冲区中的新数据移入测试录音
+    QByteArrayView span = m_ring->readSpan(m_ring->maxSpan());
+    while (!span.isEmpty()) {
+        m_monitorRecording.append(span);
+        consumeInput(span.size());
+        span = m_ring->readSpan(m_ring->maxSpan());
+    }
+
+    if (m_monitorRecording.size() - m_analyzedSize >= MONITOR_ANALYSIS_BYTES) {
+        m_analyzedSize = m_monitorRecording.size();
+        logMonitorLevel();
+    }
+
+    if (closed) {
+        finishStream();
+        emit monitorFinished(m_monitorRecording);
+        m_monitorRecording.clear();
+    }
+}
+
+void AudioPreprocessor::meterInput(qint64 size)
+{
+    // 只处理完整样本；环形缓冲区每次最多给出 maxSpan 字节的连续视图
+    const qint64 target = size & ~qint64(1);
+    while (m_meteredBytes < target) {
+        const QByteArrayView span = m_ring->peekSpan(m_meteredBytes, target - m_meteredBytes);
+        if (span.isEmpty()) {
+            break;
+        }
+        m_meter.process(span);
+        if (m_archiver) {
+            m_archiver->append(span);
+        }
+        m_meteredBytes += span.size();
+        m_unpublishedBytes += span.size();
+    }
+}
+
+void AudioPreprocessor::consumeInput(qint64 size)
+{
+    // 确保被消费的数据都已计入电平
+    meterInput(size);
+    m_ring->consume(size);
+    m_meteredBytes = qMax<qint64>(0, m_meteredBytes - size);
+}
+
+void AudioPreprocessor::finishStream()
+{
+    m_finished = true;
+    publishLevel(true);
+    if (m_archiver) {
+        m_archiver->endSession();
+    }
+}
+
+void AudioPreprocessor::publishLevel(bool force)
+{
+    if (force) {
+        // 音频流结束，音量条归零
+        m_unpublishedBytes = 0;
+        emit levelChanged(AudioLevelMeter::MIN_DB, AudioLevelMeter::MIN_DB);
+        return;
+    }
+
+    if (m_unpublishedBytes >= LEVEL_PUBLISH_BYTES) {
+        m_unpublishedBytes = 0;
+        emit levelChanged(m_meter.rmsDb(), m_meter.peakDb());
+    }
+}
+
+void AudioPreprocessor::logMonitorLevel() const
+{
+    const double db = m_meter.rmsDb();
+
+    // 输出最近一个电平窗口的分析结果
+    qDebug() << "Audio Analysis:"
+             << "\nBuffer size:" << m_monitorRecording.size() << "bytes"
+             << "\nPeak amplitude:" << m_meter.peak()
+             << "\nRMS:" << m_meter.rms()
+             << "\nDB level:" << db << "dB";
+
+    // 简单的音量等级显示
+    QString volumeBar = "|";
+    int barLength = qMax(0, qMin(50, int((db + 60) * 1.25))); // 将-60dB到-20dB映射到0-50的范围
+    volumeBar += QString(barLength, '#') + QString(50 - barLength, '-') + "|";
+    qDebug() << "Volume level:" << volumeBar;
+
+    // 检测是否有声音
+    if (db > -50) { // -50dB作为有效声音的阈值
+        qDebug() << "Sound detected!";
+    }
+}
+
+void AudioPreprocessor::holdPaddingFrame(QByteArrayView frame)
+{
+    // 超出缓存窗口的最旧静音帧被丢弃，其缓冲区直接复用于新帧
+    if (m_padding.size() < m_maxPaddingFrames) {
+        m_padding.append(QByteArray());
+    } else {
+        ++m_framesDropped;
+        if (m_metrics) {
+            m_metrics->add(PipelineMetrics::FramesSilent);
+        }
+        if (m_maxPaddingFrames == 0) {
+            return;
+        }
+        m_padding.append(m_padding.takeFirst());
+    }
+
+    QByteArray &buffer = m_padding.last();
+    buffer.resize(frame.size());
+    memcpy(buffer.data(), frame.data(), frame.size());
+}
+
+void AudioPreprocessor::endUtterance(bool sendEnd)
+{
+    // 本段刚被强制切分、之后没有再发出音频时，不必为空的一段再发结束帧
+    if (sendEnd && m_segmentBytes > 0) {
+        AudioFrame endFrame;
+        endFrame.segmentEnd = true;
+        endFrame.capturedAtNs = PipelineMetrics::now();
+        emitFrame(std::move(endFrame));
+    }
+    qDebug() << "Speech ended after" << m_silentBytes / BYTES_PER_MS << "ms of silence";
+    m_utteranceActive = false;
+    m_silentBytes = 0;
+    emit utteranceEnded();
+}
+
+void AudioPreprocessor::emitFrame(AudioFrame &&frame)
+{
+    m_segmentBytes += frame.pcm.size();
+    if (!frame.overlap && !frame.pcm.isEmpty()) {
+        // 只保留最近 SEGMENT_OVERLAP_MS 的音频，供强制切分时重复发送
+        m_recentAudio.append(frame.pcm);
+        const qsizetype excess = m_recentAudio.size() - qsizetype(SEGMENT_OVERLAP_MS) * BYTES_PER_MS;
+        if (excess > 0) {
+            m_recentAudio.remove(0, excess);
+        }
+    }
+    if (frame.segmentEnd) {
+        qDebug() << "Audio segment" << m_segmentIndex << "ends after"
+                 << m_segmentBytes / BYTES_PER_MS << "ms" << (frame.pcm.isEmpty() ? "at a pause" : "without a pause");
+        m_segmentBytes = 0;
+        ++m_segmentIndex;
+    }
+    m_output->push(std::move(frame));
+}
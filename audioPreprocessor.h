@@ -0,0 +1,113 @@
+#ifndef AUDIOPREPROCESSOR_H
+#define AUDIOPREPROCESSOR_H
+
+#include "pipelineStage.h"
+#include "spscQueue.h"
+#include "iatProtocol.h"
+#include "voiceActivityDetector.h"
+#include "audioLevelMeter.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+
+class AudioRingBuffer;
+class AudioArchiver;
+
+// 预处理阶段：从环形缓冲区按帧切分音频，经语音活动检测过滤静音帧后交给编码阶段
+// 语音开始前最近的几帧静音会被缓存，检测到语音时一并发出，保留完整的词首。
+// 新到达的音频在切帧之前先经过电平表，界面上的音量条因此不受帧长影响。
+// 长音频按段发送：本段已发送的音频超过 SEGMENT_SOFT_LIMIT_MS 后在下一个停顿处切分，
+// 到 SEGMENT_HARD_LIMIT_MS 仍无停顿时强制切分，并把切分前的 SEGMENT_OVERLAP_MS 音频重复作为下一段的开头。
+// 帧长可在会话中途调整 (网络阶段自适应)，新帧长从下一帧开始生效。
+// ListenMode 用于常开的听音模式：没有语音时只在 m_padding 中保留最近的音频作为预录缓冲，
+// 检测到语音时先发出预录音频开始一句话，语音之后静音超过 utteranceEndMs 时以空的分段结束帧结束这句话。
+// MonitorMode 用于麦克风测试，只收集录音并输出电平分析，不产生待发送的帧。
+// 设置了归档目录时，所有模式下新到达的音频在经过电平表的同时交给归档阶段写入文件。
+class AudioPreprocessor : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        StreamMode,
+        ListenMode,
+        MonitorMode
+    };
+    Q_ENUM(Mode)
+
+    AudioPreprocessor(AudioRingBuffer *ring, SpscQueue<AudioFrame> *output, QObject *parent = nullptr);
+
+    void setUpstream(PipelineStage *stage) { m_upstream = stage; }
+    void setDownstream(PipelineStage *stage) { m_downstream = stage; }
+    void setArchiver(AudioArchiver *archiver) { m_archiver = archiver; }
+
+    // 在本阶段线程中调用，下次 reset() 时生效
+    void setVoiceActivityConfig(const VoiceActivityDetector::Config &config) { m_vadConfig = config; }
+    // 在本阶段线程中调用，下次 reset() 时生效；为空时不归档
+    void setArchiveDirectory(const QString &directory) { m_archiveDirectory = directory; }
+
+public slots:
+    // 在本阶段线程中调用，立即生效；超出 [MIN_FRAME_MS, MAX_FRAME_MS] 的值被截断
+    void setFrameDuration(int msecs);
+    // 开始新会话前在本线程中清空环形缓冲区
+    void reset(AudioPreprocessor::Mode mode);
+
+signals:
+    void monitorFinished(const QByteArray &recording);
+    // 听音模式下一句话的开始和结束
+    void utteranceStarted();
+    void utteranceEnded();
+    // 每 50ms 音频发出一次，停止后发出 AudioLevelMeter::MIN_DB
+    void levelChanged(double rmsDb, double peakDb);
+
+protected:
+    void process() override;
+
+private:
+    void processMonitor();
+    void logMonitorLevel() const;
+    void meterInput(qint64 size);
+    void consumeInput(qint64 size);
+    void publishLevel(bool force = false);
+    void holdPaddingFrame(QByteArrayView frame);
+    void emitFrame(AudioFrame &&frame);
+    void endUtterance(bool sendEnd);
+    void updatePaddingLimit();
+    void finishStream();
+
+    AudioRingBuffer *m_ring;
+    SpscQueue<AudioFrame> *m_output;
+    PipelineStage *m_upstream = nullptr;
+    PipelineStage *m_downstream = nullptr;
+    AudioArchiver *m_archiver = nullptr;
+    QString m_archiveDirectory;
+
+    Mode m_mode = StreamMode;
+    bool m_finished = true;
+
+    VoiceActivityDetector::Config m_vadConfig;
+    VoiceActivityDetector m_vad;
+    qint64 m_frameBytes = qint64(DEFAULT_FRAME_MS) * BYTES_PER_MS;
+    QList<QByteArray> m_padding;  // 语音开始前缓存的静音帧，最旧的在前
+    int m_maxPaddingFrames = 0;
+    qint64 m_framesAnalyzed = 0;
+    qint64 m_framesDropped = 0;
+
+    qint64 m_segmentBytes = 0;     // 当前分段已发出的音频字节数
+    int m_segmentIndex = 0;
+    QByteArray m_recentAudio;      // 最近发出的 SEGMENT_OVERLAP_MS 音频
+    bool m_overlapPending = false; // 下一段开头需要重复 m_recentAudio
+
+    bool m_utteranceActive = false; // 听音模式：正在发送一句话
+    qint64 m_silentBytes = 0;       // 听音模式：最后一个语音帧之后的静音字节数
+
+    AudioLevelMeter m_meter;
+    qint64 m_meteredBytes = 0;     // 读位置之后已经过电平表的字节数
+    qint64 m_unpublishedBytes = 0;
+
+    QByteArray m_monitorRecording;  // 麦克风测试录音 (固定5秒)
+    qint64 m_analyzedSize = 0;
+};
+
+#endif // AUDIOPREPROCESSOR_H
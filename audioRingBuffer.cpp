@@ -0,0 +1,116 @@
+#include "audioRingBuffer.h"
+
+#include <cstring>
+
+AudioRingBuffer::AudioRingBuffer(qint64 capacity, qint64 maxSpan, QObject *parent)
+    : QIODevice(parent)
+    , m_capacity(capacity)
+    , m_maxSpan(qMin(maxSpan, capacity))
+{
+    Q_ASSERT(capacity > 0);
+
+    m_storage.resize(m_capacity + m_maxSpan);
+    m_data = m_storage.data();  // 预先取出裸指针，读写两端都不再触碰 QByteArray 的引用计数
+
+    // 无缓冲模式：读写都直接落到环形存储上，不经过 QIODevice 内部缓冲
+    open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+}
+
+qint64 AudioRingBuffer::freeSpace() const
+{
+    const qint64 readPos = m_readPos.load(std::memory_order_acquire);
+    const qint64 writePos = m_writePos.load(std::memory_order_relaxed);
+    return m_capacity - (writePos - readPos);
+}
+
+qint64 AudioRingBuffer::bytesAvailable() const
+{
+    const qint64 writePos = m_writePos.load(std::memory_order_acquire);
+    const qint64 readPos = m_readPos.load(std::memory_order_relaxed);
+    return (writePos - readPos) + QIODevice::bytesAvailable();
+}
+
+QByteArrayView AudioRingBuffer::peekSpan(qint64 offset, qint64 maxSize) const
+{
+    const qint64 writePos = m_writePos.load(std::memory_order_acquire);
+    const qint64 readPos = m_readPos.load(std::memory_order_relaxed) + qMax<qint64>(offset, 0);
+    const qint64 size = qMin(qMin(maxSize, writePos - readPos), m_maxSpan);
+
+    // 跨越存储末尾的部分落在镜像区内，因此视图总是连续的
+    return QByteArrayView(m_data + readPos % m_capacity, qMax<qint64>(size, 0));
+}
+
+void AudioRingBuffer::consume(qint64 size)
+{
+    const qint64 writePos = m_writePos.load(std::memory_order_acquire);
+    const qint64 readPos = m_readPos.load(std::memory_order_relaxed);
+    const qint64 count = qBound<qint64>(0, size, writePos - readPos);
+    m_readPos.store(readPos + count, std::memory_order_release);
+}
+
+void AudioRingBuffer::closeWriteChannel()
+{
+    m_writeClosed.store(true, std::memory_order_release);
+    emit readyRead();  // 唤醒消费端处理剩余数据
+}
+
+void AudioRingBuffer::clear()
+{
+    m_readPos.store(0, std::memory_order_relaxed);
+    m_writePos.store(0, std::memory_order_relaxed);
+    m_overflowBytes.store(0, std::memory_order_relaxed);
+    m_writeClosed.store(false, std::memory_order_release);
+}
+
+qint64 AudioRingBuffer::readData(char *data, qint64 maxSize)
+{
+    const qint64 writePos = m_writePos.load(std::memory_order_acquire);
+    const qint64 readPos = m_readPos.load(std::memory_order_relaxed);
+    const qint64 count = qMin(maxSize, writePos - readPos);
+    if (count <= 0) {
+        return 0;
+    }
+
+    const qint64 offset = readPos % m_capacity;
+    const qint64 firstPart = qMin(count, m_capacity - offset);
+    memcpy(data, m_data + offset, firstPart);
+    memcpy(data + firstPart, m_data, count - firstPart);
+
+    m_readPos.store(readPos + count, std::memory_order_release);
+    return count;
+}
+
+qint64 AudioRingBuffer::writeData(const char *data, qint64 maxSize)
+{
+    const qint64 readPos = m_readPos.load(std::memory_order_acquire);
+    const qint64 writePos = m_writePos.load(std::memory_order_relaxed);
+    const qint64 count = qMin(maxSize, m_capacity - (writePos - readPos));
+
+    if (count < maxSize) {
+        // 消费端跟不上：丢弃放不下的部分，只做计数，绝不阻塞采集线程
+        m_overflowBytes.fetch_add(maxSize - count, std::memory_order_relaxed);
+    }
+
+    if (count > 0) {
+        const qint64 offset = writePos % m_capacity;
+        const qint64 firstPart = qMin(count, m_capacity - offset);
+        const qint64 secondPart = count - firstPart;
+        memcpy(m_data + offset, data, firstPart);
+        memcpy(m_data, data + firstPart, secondPart);
+
+        // 同步镜像区：存储下标 [0, m_maxSpan) 的内容同时写到 [m_capacity, m_capacity + m_maxSpan)
+        if (offset < m_maxSpan) {
+            const qint64 mirrored = qMin(firstPart, m_maxSpan - offset);
+            memcpy(m_data + m_capacity + offset, data, mirrored);
+        }
+        if (secondPart > 0) {
+            memcpy(m_data + m_capacity, m_data, qMin(secondPart, m_maxSpan));
+        }
+
+        m_writePos.store(writePos + count, std::memory_order_release);
+        emit readyRead();
+    }
+
+    // 丢弃的数据同样视为已写入，避免 QAudioSource 将其当作设备错误
+    return maxSize;
+}
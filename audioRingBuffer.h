@@ -0,0 +1,60 @@
+#ifndef AUDIORINGBUFFER_H
+#define AUDIORINGBUFFER_H
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QByteArrayView>
+
+#include <atomic>
+
+// 固定容量的单生产者/单消费者环形缓冲区
+// 采集端 (QAudioSource) 通过 QIODevice::write() 写入，发送端按帧读取。
+// 写满时丢弃新到达的数据并累计溢出字节数，内存占用不随会话时长增长。
+// 尾部额外保留 maxSpan 字节的镜像区，readSpan() 因此总能返回连续视图而无需拷贝。
+class AudioRingBuffer : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    AudioRingBuffer(qint64 capacity, qint64 maxSpan, QObject *parent = nullptr);
+
+    qint64 capacity() const { return m_capacity; }
+    qint64 maxSpan() const { return m_maxSpan; }
+    qint64 freeSpace() const;
+    qint64 overflowBytes() const { return m_overflowBytes.load(std::memory_order_relaxed); }
+
+    // 消费端：获取最多 maxSize 字节 (且不超过 maxSpan) 的连续只读视图，
+    // 视图在 consume() 之前保持有效
+    QByteArrayView readSpan(qint64 maxSize) const { return peekSpan(0, maxSize); }
+    // 同上，但从读位置之后 offset 字节处开始，用于在消费之前预先分析数据
+    QByteArrayView peekSpan(qint64 offset, qint64 maxSize) const;
+    void consume(qint64 size);
+
+    // 生产端标记音频流结束，消费端据此发送最后一帧
+    void closeWriteChannel();
+    bool isWriteChannelClosed() const { return m_writeClosed.load(std::memory_order_acquire); }
+
+    // 仅在生产端和消费端都空闲时调用
+    void clear();
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    const qint64 m_capacity;
+    const qint64 m_maxSpan;
+    QByteArray m_storage;  // m_capacity + m_maxSpan 字节，尾部镜像开头 m_maxSpan 字节
+    char *m_data = nullptr;
+
+    // 单调递增的读写位置，取模得到存储下标
+    std::atomic<qint64> m_writePos{0};
+    std::atomic<qint64> m_readPos{0};
+    std::atomic<qint64> m_overflowBytes{0};
+    std::atomic<bool> m_writeClosed{false};
+};
+
+#endif // AUDIORINGBUFFER_H
@@ -0,0 +1,207 @@
+#include "base64Encoder.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BASE64_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+constexpr char BASE64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+qsizetype encodeScalar(const char *src, qsizetype size, char *dst)
+{
+    const uchar *in = reinterpret_cast<const uchar *>(src);
+    char *out = dst;
+
+    // 每3字节输入产生4字节输出
+    qsizetype i = 0;
+    for (; i + 3 <= size; i += 3) {
+        const quint32 chunk = (quint32(in[i]) << 16) | (quint32(in[i + 1]) << 8) | in[i + 2];
+        out[0] = BASE64_ALPHABET[(chunk >> 18) & 0x3f];
+        out[1] = BASE64_ALPHABET[(chunk >> 12) & 0x3f];
+        out[2] = BASE64_ALPHABET[(chunk >> 6) & 0x3f];
+        out[3] = BASE64_ALPHABET[chunk & 0x3f];
+        out += 4;
+    }
+
+    // 剩余1或2字节，用 '=' 补齐
+    const qsizetype remaining = size - i;
+    if (remaining > 0) {
+        quint32 chunk = quint32(in[i]) << 16;
+        if (remaining == 2) {
+            chunk |= quint32(in[i + 1]) << 8;
+        }
+        out[0] = BASE64_ALPHABET[(chunk >> 18) & 0x3f];
+        out[1] = BASE64_ALPHABET[(chunk >> 12) & 0x3f];
+        out[2] = remaining == 2 ? BASE64_ALPHABET[(chunk >> 6) & 0x3f] : '=';
+        out[3] = '=';
+        out += 4;
+    }
+
+    return out - dst;
+}
+
+#ifdef BASE64_X86_KERNELS
+
+// 向量实现采用 Muła/Lemire 的方法：
+// 1. pshufb 把每3个输入字节重排到一个32位字中 (按大端拼接所需的顺序)
+// 2. 两次16位乘法把4个6位索引分别移到各自字节的低位
+// 3. 用饱和减法和比较把索引归类到5个区间，再查表得到各区间相对 ASCII 的偏移
+
+__attribute__((target("ssse3,sse4.1")))
+__m128i encodeBlockSse(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    // 0..25 -> 13，26..51 -> 0，52..61 -> 1..10，62 -> 11，63 -> 12
+    __m128i lookup = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    lookup = _mm_or_si128(lookup, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+    const __m128i shiftLut = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(shiftLut, lookup), indices);
+}
+
+__attribute__((target("ssse3,sse4.1")))
+qsizetype encodeSse41(const char *src, qsizetype size, char *dst)
+{
+    qsizetype i = 0;
+    char *out = dst;
+
+    // 每次读取16字节、使用其中12字节，保证不越界读取
+    for (; i + 16 <= size; i += 12) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), encodeBlockSse(in));
+        out += 16;
+    }
+
+    return (out - dst) + encodeScalar(src + i, size - i, out);
+}
+
+__attribute__((target("avx2")))
+qsizetype encodeAvx2(const char *src, qsizetype size, char *dst)
+{
+    qsizetype i = 0;
+    char *out = dst;
+
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i shiftLut = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+
+    // 每次处理24字节：两个128位通道各取12字节，第二次读取延伸到 i + 28
+    for (; i + 28 <= size; i += 24) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        in = _mm256_shuffle_epi8(in, shuffle);
+
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i lookup = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        lookup = _mm256_or_si256(lookup, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+        const __m256i result = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLut, lookup), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), result);
+        out += 32;
+    }
+
+    // 尾部交给 SSE 实现，再剩下的交给标量实现
+    return (out - dst) + encodeSse41(src + i, size - i, out);
+}
+
+#endif // BASE64_X86_KERNELS
+
+using EncodeFunction = qsizetype (*)(const char *, qsizetype, char *);
+
+EncodeFunction kernelFunction(Base64Kernel kernel)
+{
+    switch (kernel) {
+#ifdef BASE64_X86_KERNELS
+    case Base64Kernel::Avx2:
+        return encodeAvx2;
+    case Base64Kernel::Sse41:
+        return encodeSse41;
+#endif
+    default:
+        return encodeScalar;
+    }
+}
+
+Base64Kernel detectKernel()
+{
+    for (Base64Kernel kernel : { Base64Kernel::Avx2, Base64Kernel::Sse41 }) {
+        if (base64KernelSupported(kernel)) {
+            return kernel;
+        }
+    }
+    return Base64Kernel::Scalar;
+}
+}
+
+bool base64KernelSupported(Base64Kernel kernel)
+{
+    switch (kernel) {
+    case Base64Kernel::Scalar:
+        return true;
+#ifdef BASE64_X86_KERNELS
+    case Base64Kernel::Sse41:
+        return __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+    case Base64Kernel::Avx2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+Base64Kernel base64ActiveKernel()
+{
+    static const Base64Kernel kernel = detectKernel();
+    return kernel;
+}
+
+const char *base64KernelName(Base64Kernel kernel)
+{
+    switch (kernel) {
+    case Base64Kernel::Avx2:
+        return "avx2";
+    case Base64Kernel::Sse41:
+        return "sse4.1";
+    default:
+        return "scalar";
+    }
+}
+
+qsizetype base64EncodeWith(Base64Kernel kernel, const char *src, qsizetype size, char *dst)
+{
+    return kernelFunction(kernel)(src, size, dst);
+}
+
+qsizetype base64Encode(const char *src, qsizetype size, char *dst)
+{
+    // 首次调用时检测 CPU 特性，此后直接调用选中的实现
+    static const EncodeFunction encode = kernelFunction(base64ActiveKernel());
+    return encode(src, size, dst);
+}
@@ -0,0 +1,31 @@
+#ifndef BASE64ENCODER_H
+#define BASE64ENCODER_H
+
+#include <QtGlobal>
+
+// 直接编码到调用方提供的缓冲区的 base64 编码器 (标准字母表，带 '=' 填充)
+// 发送路径上每帧都要编码，避免 QByteArray::toBase64() 的临时分配。
+// x86 上运行时按 CPU 特性选择 AVX2 / SSE4.1 向量实现，其余平台使用标量实现。
+
+enum class Base64Kernel {
+    Scalar,
+    Sse41,
+    Avx2
+};
+
+constexpr qsizetype base64EncodedSize(qsizetype size)
+{
+    return (size + 2) / 3 * 4;
+}
+
+// dst 至少需要 base64EncodedSize(size) 字节，返回写入的字节数
+qsizetype base64Encode(const char *src, qsizetype size, char *dst);
+
+// 指定实现编码，供基准测试和正确性校验使用；kernel 必须受当前 CPU 支持
+qsizetype base64EncodeWith(Base64Kernel kernel, const char *src, qsizetype size, char *dst);
+
+bool base64KernelSupported(Base64Kernel kernel);
+Base64Kernel base64ActiveKernel();
+const char *base64KernelName(Base64Kernel kernel);
+
+#endif // BASE64ENCODER_H
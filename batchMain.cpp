@@ -0,0 +1,123 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QThread>
+
+#include <cstdio>
+
+#include "batchTranscriber.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Transcribe PCM/WAV files with the iFlytek IAT service and write one JSON line per file.\n"
+        "Credentials default to the IAT_APP_ID, IAT_API_KEY and IAT_API_SECRET environment variables.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Files or directories (searched recursively for .pcm/.wav).", "<inputs...>");
+
+    const QCommandLineOption concurrencyOption({ "j", "concurrency" }, "Number of concurrent sessions.", "n", "4");
+    const QCommandLineOption threadsOption("threads", "Worker threads shared by all sessions (default: CPU cores).", "n", "0");
+    const QCommandLineOption outputOption({ "o", "output" }, "Write JSONL results to this file instead of stdout.", "file");
+    const QCommandLineOption pcmRateOption("pcm-rate", "Sample rate of raw .pcm files (16-bit mono).", "hz",
+                                           QString::number(SAMPLE_RATE));
+    const QCommandLineOption timeoutOption("timeout", "Give up on a file after this many seconds.", "seconds", "120");
+    const QCommandLineOption appIdOption("app-id", "Application id (overrides IAT_APP_ID).", "id");
+    const QCommandLineOption apiKeyOption("api-key", "API key (overrides IAT_API_KEY).", "key");
+    const QCommandLineOption apiSecretOption("api-secret", "API secret (overrides IAT_API_SECRET).", "secret");
+    const QCommandLineOption endpointOption("endpoint", "Service URL, e.g. a local mock_iat_server.", "url");
+    const QCommandLineOption encodingOption("encoding", "Uplink audio encoding: raw, speex-wb or lame.", "name", "raw");
+    const QCommandLineOption frameOption("frame-ms", "Audio per frame (40-400 ms), or \"adaptive\".", "ms",
+                                         QString::number(DEFAULT_FRAME_MS));
+    const QCommandLineOption cacheDirOption("cache-dir", "Reuse transcripts of identical audio from this directory.",
+                                            "dir");
+    const QCommandLineOption cacheSizeOption("cache-size", "Maximum transcript cache size in MB.", "mb", "64");
+    const QCommandLineOption verboseOption({ "v", "verbose" }, "Print pipeline debug output.");
+    parser.addOptions({ concurrencyOption, threadsOption, outputOption, pcmRateOption, timeoutOption,
+                        appIdOption, apiKeyOption, apiSecretOption, endpointOption, encodingOption, frameOption,
+                        cacheDirOption, cacheSizeOption, verboseOption });
+    parser.process(app);
+
+    QTextStream err(stderr);
+    if (parser.positionalArguments().isEmpty()) {
+        err << "No inputs given.\n\n" << parser.helpText();
+        return 2;
+    }
+
+    BatchTranscriber::Options options;
+    options.inputs = parser.positionalArguments();
+    options.concurrency = parser.value(concurrencyOption).toInt();
+    options.threads = parser.value(threadsOption).toInt();
+    options.outputPath = parser.value(outputOption);
+    options.pcmSampleRate = parser.value(pcmRateOption).toInt();
+    options.timeoutSecs = parser.value(timeoutOption).toInt();
+    if (options.concurrency <= 0 || options.pcmSampleRate <= 0 || options.timeoutSecs <= 0) {
+        err << "--concurrency, --pcm-rate and --timeout must be positive.\n";
+        return 2;
+    }
+
+    // 命令行参数优先于环境变量
+    options.credentials = IatCredentials::fromEnvironment();
+    if (parser.isSet(appIdOption)) {
+        options.credentials.appId = parser.value(appIdOption);
+    }
+    if (parser.isSet(apiKeyOption)) {
+        options.credentials.apiKey = parser.value(apiKeyOption);
+    }
+    if (parser.isSet(apiSecretOption)) {
+        options.credentials.apiSecret = parser.value(apiSecretOption);
+    }
+    if (parser.isSet(endpointOption)) {
+        options.endpoint = QUrl(parser.value(endpointOption));
+        if (!options.endpoint.isValid()) {
+            err << "Invalid --endpoint: " << parser.value(endpointOption) << "\n";
+            return 2;
+        }
+    }
+    if (!parseAudioEncoding(parser.value(encodingOption), &options.encoding)) {
+        err << "Unknown --encoding: " << parser.value(encodingOption) << "\n";
+        return 2;
+    }
+    if (!audioEncodingSupported(options.encoding)) {
+        err << "Encoding " << parser.value(encodingOption) << " is not available in this build.\n";
+        return 2;
+    }
+    if (parser.value(frameOption) == "adaptive") {
+        options.adaptiveFrames = true;
+    } else {
+        bool ok = false;
+        options.frameMs = parser.value(frameOption).toInt(&ok);
+        if (!ok || options.frameMs < MIN_FRAME_MS || options.frameMs > MAX_FRAME_MS) {
+            err << "Invalid --frame-ms: " << parser.value(frameOption) << "\n";
+            return 2;
+        }
+    }
+    options.cacheDir = parser.value(cacheDirOption);
+    const int cacheMb = parser.value(cacheSizeOption).toInt();
+    if (cacheMb <= 0) {
+        err << "--cache-size must be positive.\n";
+        return 2;
+    }
+    options.cacheMaxBytes = qint64(cacheMb) * 1024 * 1024;
+    if (!options.credentials.isComplete()) {
+        err << "Warning: incomplete credentials, the service will reject the requests.\n";
+    }
+
+    // 流水线的调试输出量很大，批量运行时默认关闭
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    BatchTranscriber transcriber(options);
+    QObject::connect(&transcriber, &BatchTranscriber::finished, &app, &QCoreApplication::exit);
+
+    QString error;
+    if (!transcriber.start(&error)) {
+        err << error << "\n";
+        return 2;
+    }
+    return app.exec();
+}
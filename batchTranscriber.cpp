@@ -0,0 +1,312 @@
+#include "batchTranscriber.h"
+#include "recognitionPipeline.h"
+#include "recognizerEngine.h"
+#include "audioFileSource.h"
+#include "transcriptCache.h"
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QTimer>
+#include <QDebug>
+
+#include <cstdio>
+
+BatchTranscriber::BatchTranscriber(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+    RecognizerEngine::Config config;
+    config.workerThreads = options.threads;
+    m_engine = new RecognizerEngine(config, this);
+}
+
+BatchTranscriber::~BatchTranscriber()
+{
+    qDeleteAll(m_sessions);
+}
+
+QStringList BatchTranscriber::collectFiles(const QStringList &inputs)
+{
+    QStringList files;
+    for (const QString &input : inputs) {
+        if (QFileInfo(input).isDir()) {
+            QStringList found;
+            QDirIterator it(input, { "*.pcm", "*.wav" }, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                found.append(it.next());
+            }
+            found.sort();
+            files.append(found);
+        } else {
+            files.append(input);
+        }
+    }
+    return files;
+}
+
+bool BatchTranscriber::start(QString *error)
+{
+    m_pending = collectFiles(m_options.inputs);
+    m_fileCount = m_pending.size();
+    if (m_pending.isEmpty()) {
+        *error = "No input files found";
+        return false;
+    }
+
+    if (m_options.outputPath.isEmpty()) {
+        m_output.open(stdout, QIODevice::WriteOnly);
+    } else {
+        m_output.setFileName(m_options.outputPath);
+        if (!m_output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            *error = QString("Cannot open output %1: %2").arg(m_options.outputPath, m_output.errorString());
+            return false;
+        }
+    }
+
+    if (!m_options.cacheDir.isEmpty()) {
+        m_cache = std::make_unique<TranscriptCache>(m_options.cacheDir, m_options.cacheMaxBytes);
+        QString cacheError;
+        if (!m_cache->open(&cacheError)) {
+            *error = QString("Cannot open cache %1: %2").arg(m_options.cacheDir, cacheError);
+            return false;
+        }
+    }
+
+    m_wallClock.start();
+
+    const int sessionCount = qMin(qMax(1, m_options.concurrency), int(m_pending.size()));
+    for (int i = 0; i < sessionCount; ++i) {
+        Session *session = new Session;
+        session->timeout = new QTimer(this);
+        session->timeout->setSingleShot(true);
+        connect(session->timeout, &QTimer::timeout, this, [this, session]() { onTimeout(session); });
+        session->pipeline = createPipeline(session);
+        m_sessions.append(session);
+    }
+
+    // 排队启动，start() 返回后才开始产生结果
+    for (Session *session : m_sessions) {
+        QTimer::singleShot(0, this, [this, session]() { startNext(session); });
+    }
+    return true;
+}
+
+RecognitionPipeline *BatchTranscriber::createPipeline(Session *session)
+{
+    RecognitionPipeline *pipeline = m_engine->createSession();
+    pipeline->setCredentials(m_options.credentials);
+    if (!m_options.endpoint.isEmpty()) {
+        pipeline->setEndpoint(m_options.endpoint);
+    }
+    pipeline->setAudioEncoding(m_options.encoding);
+    pipeline->setFrameDuration(m_options.frameMs);
+    pipeline->setAdaptiveFrameDuration(m_options.adaptiveFrames);
+    pipeline->prewarmConnections();
+
+    connect(pipeline, &RecognitionPipeline::resultReceived, this, [session](const RecognitionResult &result) {
+        session->transcript.apply(result);
+    });
+    connect(pipeline, &RecognitionPipeline::finalResultReceived, this, [session]() {
+        session->finalReceived = true;
+    });
+    connect(pipeline, &RecognitionPipeline::inputFinished, this, [session]() {
+        session->inputFinished = true;
+    });
+    connect(pipeline, &RecognitionPipeline::errorResponse, this, [session](int code, const QString &message) {
+        session->errorCode = code;
+        session->errorMessage = message;
+    });
+    // 连接断开才算会话结束，此后流水线不会再发出本会话的结果
+    connect(pipeline, &RecognitionPipeline::sessionClosed, this, [this, session]() {
+        finishSession(session);
+    });
+    return pipeline;
+}
+
+void BatchTranscriber::startNext(Session *session)
+{
+    while (!m_pending.isEmpty()) {
+        session->path = m_pending.takeFirst();
+        session->transcript.clear();
+        session->errorCode = 0;
+        session->errorMessage.clear();
+        session->audioSeconds = 0.0;
+        session->cacheKey.clear();
+        session->finalReceived = false;
+        session->inputFinished = false;
+        session->cached = false;
+        ++session->generation;
+        session->clock.start();
+
+        // 裸 PCM：16bit 单声道，采样率由命令行指定
+        QAudioFormat rawFormat;
+        rawFormat.setSampleRate(m_options.pcmSampleRate);
+        rawFormat.setChannelCount(1);
+        rawFormat.setSampleFormat(QAudioFormat::Int16);
+
+        auto source = std::make_shared<AudioFileSource>();
+        QString error;
+        if (!source->open(session->path, rawFormat, &error)) {
+            session->errorCode = -1;
+            session->errorMessage = error;
+            writeResult(*session);
+            continue;
+        }
+
+        session->audioSeconds = source->durationSecs();
+
+        if (m_cache && source->size() <= TranscriptCache::SYNC_KEY_MAX_BYTES) {
+            session->cacheKey = TranscriptCache::key(*source, session->pipeline->audioEncoding(),
+                                                   session->pipeline->endpoint());
+            QString cached;
+            if (m_cache->lookup(session->cacheKey, &cached)) {
+                applyCachedResult(session, cached);
+                writeResult(*session);
+                continue;
+            }
+        } else if (m_cache) {
+            // 长录音的键在线程池中计算，不阻塞其他会话的调度，本文件也照常开始发送
+            const quint64 generation = session->generation;
+            TranscriptCache::keyAsync(session->path, rawFormat, session->pipeline->audioEncoding(),
+                                      session->pipeline->endpoint())
+                .then(this, [this, session, generation](const QByteArray &key) {
+                    onFileKeyReady(session, generation, key);
+                });
+        }
+
+        session->active = true;
+        session->timeout->start(m_options.timeoutSecs * 1000);
+        session->pipeline->startSource(std::move(source));
+        return;
+    }
+
+    // 没有待处理的文件，最后一个会话结束时汇总
+    session->active = false;
+    for (const Session *other : m_sessions) {
+        if (other->active) {
+            return;
+        }
+    }
+    printSummary();
+    m_output.flush();
+    emit finished(m_failed > 0 ? 1 : 0);
+}
+
+void BatchTranscriber::finishSession(Session *session)
+{
+    if (!session->active) {
+        return;
+    }
+    session->timeout->stop();
+    session->active = false;
+    // 会话结束却没有最终结果，或文件没有全部送入：文本可能缺少结尾，按失败处理，下次重新识别
+    if (session->errorCode == 0 && !(session->finalReceived && session->inputFinished)) {
+        session->errorCode = -1;
+        session->errorMessage = session->finalReceived ? "input ended before the whole file was sent"
+                                                       : "no final result";
+    }
+    if (m_cache && !session->cacheKey.isEmpty() && session->errorCode == 0) {
+        m_cache->insert(session->cacheKey, session->transcript.text());
+    }
+    writeResult(*session);
+    startNext(session);
+}
+
+void BatchTranscriber::onTimeout(Session *session)
+{
+    if (!session->active) {
+        return;
+    }
+    session->active = false;
+    session->errorCode = -1;
+    session->errorMessage = QString("timed out after %1 s").arg(m_options.timeoutSecs);
+    writeResult(*session);
+
+    // 超时的流水线可能还有排队中的结果，直接换一条新的，避免串到下一个文件
+    delete session->pipeline;
+    session->pipeline = createPipeline(session);
+    startNext(session);
+}
+
+void BatchTranscriber::onFileKeyReady(Session *session, quint64 generation, const QByteArray &key)
+{
+    if (!session->active || session->generation != generation || key.isEmpty()) {
+        return;
+    }
+    QString cached;
+    if (!m_cache->lookup(key, &cached)) {
+        session->cacheKey = key;
+        return;
+    }
+
+    // 命中：放弃正在上传的会话，与超时相同换一条新的流水线
+    session->timeout->stop();
+    session->active = false;
+    applyCachedResult(session, cached);
+    writeResult(*session);
+    delete session->pipeline;
+    session->pipeline = createPipeline(session);
+    startNext(session);
+}
+
+void BatchTranscriber::applyCachedResult(Session *session, const QString &text)
+{
+    RecognitionResult result;
+    result.sn = 1;
+    result.last = true;
+    result.text = text;
+    session->transcript.clear();
+    session->transcript.apply(result);
+    session->cached = true;
+    ++m_cacheHits;
+}
+
+void BatchTranscriber::writeResult(const Session &session)
+{
+    const bool ok = session.errorCode == 0;
+    if (ok) {
+        ++m_succeeded;
+        m_audioSeconds += session.audioSeconds;
+    } else {
+        ++m_failed;
+    }
+
+    QJsonObject result;
+    result["file"] = session.path;
+    result["ok"] = ok;
+    result["text"] = session.transcript.text();
+    result["audio_seconds"] = session.audioSeconds;
+    result["elapsed_ms"] = session.clock.elapsed();
+    if (session.cached) {
+        result["cached"] = true;
+    }
+    if (!ok) {
+        result["error_code"] = session.errorCode;
+        result["error"] = session.errorMessage;
+    }
+
+    // 逐行写出并刷新，中途中断时已完成的结果不会丢失
+    m_output.write(QJsonDocument(result).toJson(QJsonDocument::Compact));
+    m_output.write("\n");
+    m_output.flush();
+}
+
+void BatchTranscriber::printSummary() const
+{
+    const double wallSeconds = m_wallClock.elapsed() / 1000.0;
+    QTextStream err(stderr);
+    err << QString("Files: %1  succeeded: %2  failed: %3\n").arg(m_fileCount).arg(m_succeeded).arg(m_failed);
+    err << QString("Audio: %1 s  wall: %2 s  throughput: %3 audio-s/wall-s\n")
+               .arg(m_audioSeconds, 0, 'f', 1)
+               .arg(wallSeconds, 0, 'f', 1)
+               .arg(wallSeconds > 0 ? m_audioSeconds / wallSeconds : 0.0, 0, 'f', 2);
+    if (m_cache) {
+        err << QString("Cache hits: %1  entries: %2  size: %3 KB\n")
+                   .arg(m_cacheHits)
+                   .arg(m_cache->entryCount())
+                   .arg(m_cache->totalBytes() / 1024);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef BATCHTRANSCRIBER_H
+#define BATCHTRANSCRIBER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+#include <memory>
+
+#include "audioCodec.h"
+#include "iatCredentials.h"
+#include "iatProtocol.h"
+#include "transcript.h"
+
+class QTimer;
+class RecognitionPipeline;
+class RecognizerEngine;
+class TranscriptCache;
+
+// 无界面批量转写：同时运行至多 concurrency 个识别会话，
+// 每个会话占用一条 RecognitionPipeline，完成后接着处理下一个文件。
+// 所有会话由同一个 RecognizerEngine 调度，线程数固定，不随并发数增长。
+// 每个文件的结果完成后立即以一行 JSON 写出 (JSONL)，结束时在 stderr 输出吞吐量汇总。
+// 指定缓存目录时，识别过的音频直接从缓存取结果，不再占用会话和连接。
+class BatchTranscriber : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QStringList inputs;              // 文件或目录，目录中递归查找 .pcm/.wav
+        int concurrency = 4;
+        int threads = 0;                 // 引擎工作线程数，<= 0 时按 CPU 核数
+        QString outputPath;              // 为空时写到标准输出
+        int pcmSampleRate = SAMPLE_RATE; // .pcm 文件按 16bit 单声道和此采样率解释
+        int timeoutSecs = 120;           // 单个文件的最长处理时间
+        IatCredentials credentials;
+        QUrl endpoint;                   // 为空时使用默认服务地址
+        AudioEncoding encoding = AudioEncoding::Raw;  // 上行音频编码
+        int frameMs = DEFAULT_FRAME_MS;  // 每帧音频时长
+        bool adaptiveFrames = false;     // 按链路状况自动调整帧长，frameMs 为初始值
+        QString cacheDir;                // 识别结果缓存目录，为空时不使用缓存
+        qint64 cacheMaxBytes = 64 * 1024 * 1024;
+    };
+
+    explicit BatchTranscriber(const Options &options, QObject *parent = nullptr);
+    ~BatchTranscriber() override;
+
+    // 开始处理；失败时返回 false 并写明原因，成功后全部完成时发出 finished()
+    bool start(QString *error);
+
+signals:
+    // 全部文件成功为 0，有文件失败为 1
+    void finished(int exitCode);
+
+private:
+    struct Session
+    {
+        RecognitionPipeline *pipeline = nullptr;
+        QTimer *timeout = nullptr;
+        QString path;
+        Transcript transcript;  // 按 wpgs 修正后的识别结果
+        double audioSeconds = 0.0;
+        int errorCode = 0;
+        QString errorMessage;
+        QElapsedTimer clock;
+        QByteArray cacheKey;      // 为空表示不写入缓存
+        bool finalReceived = false;
+        bool inputFinished = false;  // 文件已读到末尾
+        bool cached = false;      // 结果取自缓存
+        bool active = false;
+        quint64 generation = 0;   // 每换一个文件递增，丢弃属于之前文件的后台计算结果
+    };
+
+    static QStringList collectFiles(const QStringList &inputs);
+
+    RecognitionPipeline *createPipeline(Session *session);
+    void startNext(Session *session);
+    void finishSession(Session *session);
+    void onTimeout(Session *session);
+    void onFileKeyReady(Session *session, quint64 generation, const QByteArray &key);
+    void applyCachedResult(Session *session, const QString &text);
+    void writeResult(const Session &session);
+    void printSummary() const;
+
+    Options m_options;
+    RecognizerEngine *m_engine;
+    QList<Session *> m_sessions;
+    QStringList m_pending;
+    QFile m_output;
+    std::unique_ptr<TranscriptCache> m_cache;
+
+    QElapsedTimer m_wallClock;
+    int m_fileCount = 0;
+    int m_succeeded = 0;
+    int m_failed = 0;
+    int m_cacheHits = 0;
+    double m_audioSeconds = 0.0;
+};
+
+#endif // BATCHTRANSCRIBER_H
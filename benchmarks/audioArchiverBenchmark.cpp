@@ -0,0 +1,92 @@
+#include "benchmarkSuite.h"
+#include "audioArchiver.h"
+#include "audioFileSource.h"
+#include "iatProtocol.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <memory>
+
+namespace {
+constexpr qsizetype APPEND_BYTES = 3200;  // 采集回调的典型数据量，100ms
+
+// 按采集节拍逐块追加，析构时写完剩余音频；写出的 WAV 要能按文件头读回原样的数据
+bool verifyArchive(QString *error)
+{
+    QTemporaryDir dir;
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+
+    {
+        AudioArchiver archiver;
+        archiver.beginSession(dir.path());
+        for (qsizetype offset = 0; offset < pcm.size(); offset += APPEND_BYTES) {
+            archiver.append(QByteArrayView(pcm).sliced(offset, qMin(APPEND_BYTES, pcm.size() - offset)));
+        }
+        archiver.endSession();
+    }
+
+    const QStringList files = QDir(dir.path()).entryList({ "*.wav" }, QDir::Files);
+    if (files.size() != 1) {
+        *error = QString("expected one archive, found %1").arg(files.size());
+        return false;
+    }
+
+    AudioFileSource source;
+    if (!source.open(QDir(dir.path()).filePath(files.first()), QAudioFormat(), error)) {
+        return false;
+    }
+    if (source.format().sampleRate() != SAMPLE_RATE || source.format().channelCount() != 1) {
+        *error = QString("archive format is %1 Hz x %2").arg(source.format().sampleRate()).arg(source.format().channelCount());
+        return false;
+    }
+    if (source.size() != pcm.size()) {
+        *error = QString("archive holds %1 bytes, expected %2").arg(source.size()).arg(pcm.size());
+        return false;
+    }
+    QByteArray archived;
+    for (QByteArrayView chunk = source.read(pcm.size()); !chunk.isEmpty(); chunk = source.read(pcm.size())) {
+        archived.append(chunk);
+    }
+    if (archived != pcm) {
+        *error = "archived audio differs from the input";
+        return false;
+    }
+    return true;
+}
+
+// 生产端只有拷贝，池用尽后 (没有归档线程消费) 直接丢弃，不会分配更多内存
+bool verifyBoundedPool(QString *error)
+{
+    QTemporaryDir dir;
+    auto archiver = std::make_unique<AudioArchiver>();
+    archiver->beginSession(dir.path());
+    const QByteArray block(AudioArchiver::BLOCK_BYTES, '\0');
+    for (int i = 0; i < AudioArchiver::POOL_BLOCKS * 4; ++i) {
+        archiver->append(block);
+    }
+    archiver->endSession();
+    archiver.reset();
+
+    const QStringList files = QDir(dir.path()).entryList({ "*.wav" }, QDir::Files);
+    if (files.size() != 1) {
+        *error = QString("expected one archive, found %1").arg(files.size());
+        return false;
+    }
+    const qint64 size = QFileInfo(QDir(dir.path()).filePath(files.first())).size();
+    const qint64 expected = AudioArchiver::HEADER_BYTES + AudioArchiver::BLOCK_BYTES * AudioArchiver::POOL_BLOCKS;
+    if (size != expected) {
+        *error = QString("archive is %1 bytes, expected the pool bound %2").arg(size).arg(expected);
+        return false;
+    }
+    return true;
+}
+}
+
+// 归档写盘在单独的线程上，这里只校验文件内容和内存上限
+void registerAudioArchiverBenchmarks(BenchmarkSuite &suite)
+{
+    suite.addCheck("archive/round_trip", verifyArchive);
+    suite.addCheck("archive/bounded_pool", verifyBoundedPool);
+}
@@ -0,0 +1,67 @@
+#include "benchmarkSuite.h"
+#include "audioCodec.h"
+#include "iatProtocol.h"
+
+#include <QSharedPointer>
+
+#include <memory>
+
+namespace {
+constexpr AudioEncoding ALL_ENCODINGS[] = { AudioEncoding::Raw, AudioEncoding::SpeexWb, AudioEncoding::Lame };
+constexpr qsizetype FRAME_BYTES = DEFAULT_FRAME_MS * BYTES_PER_MS;
+constexpr double MIN_COMPRESSION_RATIO = 3.0;  // 相对 256 kbps 的 PCM：speex-wb 约 9 倍，32 kbps MP3 为 8 倍
+
+// 整段样例录音按 pipeline 的默认帧长逐帧编码，检查压缩比
+bool verifyCodec(AudioEncoding encoding, QString *error)
+{
+    std::unique_ptr<AudioCodec> codec = createAudioCodec(encoding);
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+
+    qint64 encodedBytes = 0;
+    for (qsizetype offset = 0; offset < pcm.size(); offset += FRAME_BYTES) {
+        const QByteArrayView frame(pcm.constData() + offset, qMin<qsizetype>(FRAME_BYTES, pcm.size() - offset));
+        const bool last = offset + FRAME_BYTES >= pcm.size();
+        const QByteArrayView encoded = codec->encode(frame, last);
+        if (encoded.size() > codec->maxEncodedSize(frame.size())) {
+            *error = QString("%1 bytes exceed the %2 byte bound").arg(encoded.size()).arg(codec->maxEncodedSize(frame.size()));
+            return false;
+        }
+        encodedBytes += encoded.size();
+    }
+
+    if (encoding == AudioEncoding::Raw) {
+        if (encodedBytes != pcm.size()) {
+            *error = QString("raw output is %1 bytes, expected %2").arg(encodedBytes).arg(pcm.size());
+            return false;
+        }
+        return true;
+    }
+
+    const double ratio = encodedBytes > 0 ? double(pcm.size()) / encodedBytes : 0.0;
+    if (ratio < MIN_COMPRESSION_RATIO) {
+        *error = QString("compression ratio %1 is below %2").arg(ratio, 0, 'f', 2).arg(MIN_COMPRESSION_RATIO);
+        return false;
+    }
+    return true;
+}
+}
+
+// 压缩编码在编码线程上逐帧运行，需要远快于实时
+void registerAudioCodecBenchmarks(BenchmarkSuite &suite)
+{
+    const QByteArray frame = BenchmarkSuite::samplePcmFrame();
+
+    for (AudioEncoding encoding : ALL_ENCODINGS) {
+        if (!audioEncodingSupported(encoding)) {
+            continue;
+        }
+        const QString name = QString::fromLatin1(audioEncodingName(encoding));
+        suite.addCheck(QString("codec/%1_ratio").arg(name),
+                       [encoding](QString *error) { return verifyCodec(encoding, error); });
+
+        QSharedPointer<AudioCodec> codec(createAudioCodec(encoding).release());
+        suite.add(QString("codec/%1").arg(name), frame.size(), [frame, codec]() {
+            BenchmarkSuite::keep(codec->encode(frame, false).size());
+        });
+    }
+}
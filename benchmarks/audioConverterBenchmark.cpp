@@ -0,0 +1,52 @@
+#include "benchmarkSuite.h"
+#include "audioConverter.h"
+#include "iatProtocol.h"
+
+#include <QSharedPointer>
+#include <QtMath>
+
+namespace {
+// 100ms 的 440Hz 正弦波，按给定格式交织存放
+QByteArray makeInput(const QAudioFormat &format)
+{
+    const int frames = format.sampleRate() / 10;
+    QByteArray data(frames * format.bytesPerFrame(), Qt::Uninitialized);
+    for (int i = 0; i < frames; ++i) {
+        const double value = 0.5 * qSin(2 * M_PI * 440 * i / format.sampleRate());
+        for (int c = 0; c < format.channelCount(); ++c) {
+            char *sample = data.data() + i * format.bytesPerFrame() + c * format.bytesPerSample();
+            if (format.sampleFormat() == QAudioFormat::Float) {
+                *reinterpret_cast<float *>(sample) = float(value);
+            } else {
+                *reinterpret_cast<qint16 *>(sample) = qint16(value * 32767);
+            }
+        }
+    }
+    return data;
+}
+
+void addConversion(BenchmarkSuite &suite, const QString &name, int sampleRate, int channels,
+                   QAudioFormat::SampleFormat sampleFormat)
+{
+    QAudioFormat format;
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(channels);
+    format.setSampleFormat(sampleFormat);
+
+    const QByteArray input = makeInput(format);
+    auto converter = QSharedPointer<AudioConverter>::create();
+    converter->setInputFormat(format);
+
+    // 吞吐量按输出的 16k 单声道字节数计算，便于不同输入格式之间比较
+    suite.add(name, 100 * BYTES_PER_MS, [input, converter]() {
+        BenchmarkSuite::keep(converter->convert(input).size());
+    });
+}
+}
+
+void registerAudioConverterBenchmarks(BenchmarkSuite &suite)
+{
+    addConversion(suite, "convert/48k_stereo_float", 48000, 2, QAudioFormat::Float);
+    addConversion(suite, "convert/44k1_stereo_int16", 44100, 2, QAudioFormat::Int16);
+    addConversion(suite, "convert/8k_mono_int16", 8000, 1, QAudioFormat::Int16);
+}
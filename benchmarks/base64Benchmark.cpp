@@ -0,0 +1,77 @@
+#include "benchmarkSuite.h"
+#include "base64Encoder.h"
+
+#include <QRandomGenerator>
+#include <QSharedPointer>
+
+namespace {
+const Base64Kernel ALL_KERNELS[] = { Base64Kernel::Scalar, Base64Kernel::Sse41, Base64Kernel::Avx2 };
+
+// 以 QByteArray::toBase64() 为参照，逐一校验当前 CPU 支持的所有实现
+bool verifyKernel(Base64Kernel kernel, QString *error)
+{
+    QRandomGenerator random(20240521);
+    QByteArray output;
+
+    // 覆盖 0..1024 的所有长度 (包含各向量块边界和 1/2 字节尾部)，外加一整帧
+    QList<QByteArray> inputs;
+    for (int size = 0; size <= 1024; ++size) {
+        QByteArray input(size, Qt::Uninitialized);
+        for (char &byte : input) {
+            byte = char(random.bounded(256));
+        }
+        inputs.append(input);
+    }
+    inputs.append(BenchmarkSuite::samplePcmFrame());
+
+    for (const QByteArray &input : inputs) {
+        const QByteArray expected = input.toBase64();
+
+        // 输出缓冲区多留几字节哨兵，检查实现没有越界写入
+        output.fill('#', base64EncodedSize(input.size()) + 8);
+        const qsizetype written = base64EncodeWith(kernel, input.constData(), input.size(), output.data());
+
+        if (written != expected.size()
+            || output.left(written) != expected
+            || output.mid(written) != QByteArray(8, '#')) {
+            *error = QString("%1 kernel mismatch for %2-byte input")
+                         .arg(base64KernelName(kernel))
+                         .arg(input.size());
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+void registerBase64Benchmarks(BenchmarkSuite &suite)
+{
+    for (Base64Kernel kernel : ALL_KERNELS) {
+        if (base64KernelSupported(kernel)) {
+            suite.addCheck(QString("base64/verify_%1").arg(base64KernelName(kernel)),
+                           [kernel](QString *error) { return verifyKernel(kernel, error); });
+        }
+    }
+
+    const QByteArray frame = BenchmarkSuite::samplePcmFrame();
+
+    // 参照：Qt 自带实现，每次分配新的 QByteArray
+    suite.add("base64/qt_to_base64", frame.size(), [frame]() {
+        BenchmarkSuite::keep(frame.toBase64().size());
+    });
+
+    auto output = QSharedPointer<QByteArray>::create(base64EncodedSize(frame.size()), Qt::Uninitialized);
+    for (Base64Kernel kernel : ALL_KERNELS) {
+        if (!base64KernelSupported(kernel)) {
+            continue;
+        }
+        suite.add(QString("base64/%1").arg(base64KernelName(kernel)), frame.size(), [frame, output, kernel]() {
+            BenchmarkSuite::keep(base64EncodeWith(kernel, frame.constData(), frame.size(), output->data()));
+        });
+    }
+
+    // 发送路径实际使用的运行时分派入口
+    suite.add("base64/dispatch", frame.size(), [frame, output]() {
+        BenchmarkSuite::keep(base64Encode(frame.constData(), frame.size(), output->data()));
+    });
+}
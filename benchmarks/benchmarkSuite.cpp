@@ -0,0 +1,249 @@
+#include "benchmarkSuite.h"
+#include "iatProtocol.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QtMath>
+
+#include <atomic>
+#include <cstdio>
+
+namespace {
+constexpr qint64 MIN_MEASURE_NS = 200 * 1000 * 1000;  // 单个用例至少测量 200ms
+std::atomic<qint64> g_sink{0};
+}
+
+void BenchmarkSuite::add(const QString &name, qint64 bytesPerOp, Operation operation)
+{
+    m_cases.append({ name, bytesPerOp, std::move(operation) });
+}
+
+void BenchmarkSuite::addCheck(const QString &name, Check check)
+{
+    m_checks.append({ name, std::move(check) });
+}
+
+void BenchmarkSuite::keep(qint64 value)
+{
+    g_sink.fetch_add(value, std::memory_order_relaxed);
+}
+
+QByteArray BenchmarkSuite::samplePcm()
+{
+    QFile file(QStringLiteral(SPEECH_SOURCE_DIR "/iat_pcm_16k.pcm"));
+    if (file.open(QIODevice::ReadOnly)) {
+        return file.readAll();
+    }
+
+    // 找不到样例文件时生成 5 秒 440Hz 正弦波
+    QByteArray pcm(5 * SAMPLE_RATE * 2, Qt::Uninitialized);
+    int16_t *samples = reinterpret_cast<int16_t *>(pcm.data());
+    for (int i = 0; i < pcm.size() / 2; ++i) {
+        samples[i] = int16_t(8000 * qSin(2 * M_PI * 440 * i / SAMPLE_RATE));
+    }
+    return pcm;
+}
+
+QByteArray BenchmarkSuite::samplePcmFrame()
+{
+    // 跳过开头的静音段，取中间一帧；按最大帧长取，各项耗时与帧长成正比
+    const QByteArray pcm = samplePcm();
+    const qsizetype offset = qMax<qsizetype>(0, qMin<qsizetype>(pcm.size() / 2, pcm.size() - MAX_FRAME_SIZE));
+    QByteArray frame = pcm.mid(offset, MAX_FRAME_SIZE);
+    frame.resize(MAX_FRAME_SIZE, '\0');
+    return frame;
+}
+
+bool BenchmarkSuite::runChecks(const QString &filter) const
+{
+    QTextStream out(stdout);
+    bool passed = true;
+
+    for (const NamedCheck &check : m_checks) {
+        if (!filter.isEmpty() && !check.name.contains(filter)) {
+            continue;
+        }
+
+        QString error;
+        if (check.check(&error)) {
+            out << QString("%1 ok\n").arg(check.name, -40);
+        } else {
+            out << QString("%1 FAILED: %2\n").arg(check.name, -40).arg(error);
+            passed = false;
+        }
+    }
+
+    out << "\n";
+    out.flush();
+    return passed;
+}
+
+BenchmarkSuite::Result BenchmarkSuite::measure(const Case &benchmark) const
+{
+    // 预热
+    for (int i = 0; i < 3; ++i) {
+        benchmark.operation();
+    }
+
+    // 迭代次数逐步翻倍，直到单轮耗时超过测量下限
+    qint64 iterations = 1;
+    qint64 elapsedNs = 0;
+    for (;;) {
+        QElapsedTimer timer;
+        timer.start();
+        for (qint64 i = 0; i < iterations; ++i) {
+            benchmark.operation();
+        }
+        elapsedNs = timer.nsecsElapsed();
+        if (elapsedNs >= MIN_MEASURE_NS) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    Result result;
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    result.nsPerOp = double(elapsedNs) / iterations;
+    result.mbPerSec = benchmark.bytesPerOp > 0 ? benchmark.bytesPerOp / result.nsPerOp * 1e9 / (1024 * 1024) : 0.0;
+    return result;
+}
+
+bool BenchmarkSuite::loadBaseline(const QString &path, QHash<QString, double> *nsPerOp, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        *error = parseError.errorString();
+        return false;
+    }
+
+    const QJsonArray benchmarks = document.object().value("benchmarks").toArray();
+    for (const QJsonValue &value : benchmarks) {
+        const QJsonObject entry = value.toObject();
+        const double ns = entry.value("ns_per_op").toDouble();
+        if (ns > 0) {
+            nsPerOp->insert(entry.value("name").toString(), ns);
+        }
+    }
+    return true;
+}
+
+bool BenchmarkSuite::writeJson(const QString &path, const QList<Result> &results, QString *error)
+{
+    QJsonArray benchmarks;
+    for (const Result &result : results) {
+        QJsonObject entry;
+        entry["name"] = result.name;
+        entry["iterations"] = result.iterations;
+        entry["ns_per_op"] = result.nsPerOp;
+        entry["mb_per_s"] = result.mbPerSec;
+        benchmarks.append(entry);
+    }
+
+    // 记录测量环境，基线只在同一台机器、同一构建类型之间比较才有意义
+    QJsonObject root;
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["host"] = QSysInfo::machineHostName();
+    root["cpu_architecture"] = QSysInfo::currentCpuArchitecture();
+    root["qt_version"] = QString::fromLatin1(qVersion());
+    root["benchmarks"] = benchmarks;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    if (!file.commit()) {
+        *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+int BenchmarkSuite::run(const RunOptions &options) const
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    // 先读基线，路径写错时不必等全部用例跑完才发现
+    QHash<QString, double> baseline;
+    QString error;
+    if (!options.baselinePath.isEmpty() && !loadBaseline(options.baselinePath, &baseline, &error)) {
+        err << "Cannot read baseline " << options.baselinePath << ": " << error << "\n";
+        return 2;
+    }
+
+    // 结果不正确时测得的速度没有意义，直接失败
+    if (!runChecks(options.filter)) {
+        return 1;
+    }
+
+    const bool compare = !options.baselinePath.isEmpty();
+    out << QString("%1 %2 %3 %4").arg("benchmark", -40).arg("iterations", 12).arg("ns/op", 14).arg("MB/s", 10);
+    if (compare) {
+        out << QString(" %1").arg("vs baseline", 12);
+    }
+    out << "\n";
+    out.flush();
+
+    QList<Result> results;
+    QStringList regressions;
+    for (const Case &benchmark : m_cases) {
+        if (!options.filter.isEmpty() && !benchmark.name.contains(options.filter)) {
+            continue;
+        }
+
+        const Result result = measure(benchmark);
+        results.append(result);
+        out << QString("%1 %2 %3 %4")
+                   .arg(result.name, -40)
+                   .arg(result.iterations, 12)
+                   .arg(result.nsPerOp, 14, 'f', 1)
+                   .arg(result.mbPerSec, 10, 'f', 1);
+
+        if (compare) {
+            // 基线中没有的新用例只报告，不算回退
+            const double baselineNs = baseline.value(result.name);
+            if (baselineNs > 0) {
+                const double change = result.nsPerOp / baselineNs - 1.0;
+                out << QString(" %1").arg(QString::asprintf("%+.1f%%", change * 100), 12);
+                if (change > options.tolerance) {
+                    out << "  REGRESSION";
+                    regressions.append(result.name);
+                }
+            } else {
+                out << QString(" %1").arg("new", 12);
+            }
+        }
+        out << "\n";
+        out.flush();
+    }
+
+    if (!options.jsonPath.isEmpty() && !writeJson(options.jsonPath, results, &error)) {
+        err << "Cannot write " << options.jsonPath << ": " << error << "\n";
+        return 2;
+    }
+
+    if (!regressions.isEmpty()) {
+        out << QString("\n%1 benchmark(s) slower than the baseline by more than %2%: %3\n")
+                   .arg(regressions.size())
+                   .arg(options.tolerance * 100, 0, 'f', 0)
+                   .arg(regressions.join(", "));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#ifndef BENCHMARKSUITE_H
+#define BENCHMARKSUITE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+// 微基准测试框架：每个用例自动增加迭代次数直到单轮耗时足够长，
+// 输出每次操作耗时和吞吐量，可另存为 JSON 供脚本处理。
+// 正确性校验在所有用例之前运行，任一校验失败则整个进程以非零退出码结束。
+// 指定基线 (之前保存的 JSON) 时逐项比较每次操作耗时，任一用例变慢超过容差同样以非零退出码结束。
+class BenchmarkSuite
+{
+public:
+    using Operation = std::function<void()>;
+    using Check = std::function<bool(QString *error)>;
+
+    struct RunOptions
+    {
+        QString filter;          // 只运行名称包含此文本的校验和用例
+        QString jsonPath;        // 结果另存为 JSON，可直接用作之后的基线
+        QString baselinePath;    // 基线 JSON，为空时不比较
+        double tolerance = 0.25; // 允许比基线慢的比例
+    };
+
+    // bytesPerOp 为每次操作处理的输入字节数，用于计算吞吐量，0 表示不统计
+    void add(const QString &name, qint64 bytesPerOp, Operation operation);
+
+    // 校验失败时返回 false 并在 error 中写明原因
+    void addCheck(const QString &name, Check check);
+
+    // 运行校验和用例，返回进程退出码：校验失败或性能回退为 1，基线或结果文件读写失败为 2
+    int run(const RunOptions &options) const;
+
+    // 防止编译器把基准测试中的计算结果当作无用代码消除
+    static void keep(qint64 value);
+
+    // 基准测试输入：仓库自带的 16k PCM 录音，不存在时返回合成的正弦波
+    static QByteArray samplePcm();
+    static QByteArray samplePcmFrame();
+
+private:
+    struct Case
+    {
+        QString name;
+        qint64 bytesPerOp;
+        Operation operation;
+    };
+
+    struct NamedCheck
+    {
+        QString name;
+        Check check;
+    };
+
+    struct Result
+    {
+        QString name;
+        qint64 iterations = 0;
+        double nsPerOp = 0.0;
+        double mbPerSec = 0.0;
+    };
+
+    bool runChecks(const QString &filter) const;
+    Result measure(const Case &benchmark) const;
+    static bool loadBaseline(const QString &path, QHash<QString, double> *nsPerOp, QString *error);
+    static bool writeJson(const QString &path, const QList<Result> &results, QString *error);
+
+    QList<Case> m_cases;
+    QList<NamedCheck> m_checks;
+};
+
+void registerFrameWriterBenchmarks(BenchmarkSuite &suite);
+void registerBase64Benchmarks(BenchmarkSuite &suite);
+void registerVoiceActivityBenchmarks(BenchmarkSuite &suite);
+void registerLevelMeterBenchmarks(BenchmarkSuite &suite);
+void registerAudioConverterBenchmarks(BenchmarkSuite &suite);
+void registerResultParserBenchmarks(BenchmarkSuite &suite);
+void registerAudioCodecBenchmarks(BenchmarkSuite &suite);
+void registerTranscriptCacheBenchmarks(BenchmarkSuite &suite);
+void registerAudioArchiverBenchmarks(BenchmarkSuite &suite);
+void registerSessionBenchmarks(BenchmarkSuite &suite);
+
+#endif // BENCHMARKSUITE_H
@@ -0,0 +1,35 @@
+#include "benchmarkSuite.h"
+#include "iatFrameWriter.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSharedPointer>
+
+// 对比原 sendAudioData() 的帧构造路径与 IatFrameWriter
+void registerFrameWriterBenchmarks(BenchmarkSuite &suite)
+{
+    const QByteArray frame = BenchmarkSuite::samplePcmFrame();
+
+    // 原路径：两个 QJsonObject、缩进输出、base64 拷贝到 QString，发送时再转回 UTF-8
+    suite.add("frame_json/qjsondocument", frame.size(), [frame]() {
+        QJsonObject json;
+        QJsonObject data;
+        data["status"] = STATUS_CONTINUE_FRAME;
+        data["format"] = "audio/L16;rate=16000";
+        data["encoding"] = "raw";
+        data["audio"] = QString(frame.toBase64());
+        json["data"] = data;
+
+        QString message = QJsonDocument(json).toJson();
+        BenchmarkSuite::keep(message.toUtf8().size());
+    });
+
+    // 新路径：预生成前后缀，base64 直接写入复用的缓冲区
+    auto writer = QSharedPointer<IatFrameWriter>::create();
+    auto buffer = QSharedPointer<QByteArray>::create();
+    buffer->reserve(writer->maxFrameSize(frame.size()));
+    suite.add("frame_json/frame_writer", frame.size(), [frame, writer, buffer]() {
+        writer->writeFrame(*buffer, STATUS_CONTINUE_FRAME, frame);
+        BenchmarkSuite::keep(buffer->size());
+    });
+}
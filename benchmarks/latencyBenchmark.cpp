@@ -0,0 +1,266 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+
+#include "mockIatServer.h"
+#include "recognitionPipeline.h"
+
+// 端到端延迟测量：识别流水线对接本地模拟服务，统计
+//   - 每帧发送延迟：服务端收到该帧的时刻 - 该帧音频就绪的时刻 (帧长可变，按已收到的音频时长计算)
+//   - 首个中间结果和最终结果的到达时间
+// realtime 模式按麦克风节拍回放文件，file 模式一次性送入全部音频。
+
+namespace {
+constexpr int RUN_TIMEOUT_MS = 120000;
+
+struct RunResult
+{
+    QList<double> frameLatencyMs;
+    double firstPartialMs = -1;
+    double finalMs = -1;
+    bool ok = false;
+};
+
+struct Summary
+{
+    double p50 = 0;
+    double p95 = 0;
+    double max = 0;
+    double mean = 0;
+};
+
+Summary summarize(QList<double> values)
+{
+    Summary summary;
+    if (values.isEmpty()) {
+        return summary;
+    }
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](double p) {
+        const int index = qBound(0, int(p * (values.size() - 1) + 0.5), int(values.size()) - 1);
+        return values[index];
+    };
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.max = values.last();
+    double total = 0;
+    for (double value : values) {
+        total += value;
+    }
+    summary.mean = total / values.size();
+    return summary;
+}
+
+RunResult runOnce(RecognitionPipeline &pipeline, MockIatServer &server, const QByteArray &pcm, bool realTime)
+{
+    RunResult result;
+    const qint64 durationMs = pcm.size() / BYTES_PER_MS;
+
+    QElapsedTimer clock;
+    QEventLoop loop;
+    QList<QMetaObject::Connection> connections;
+
+    connections << QObject::connect(&server, &MockIatServer::frameReceived, [&](int, int, qint64 audioMs) {
+        // 实时模式下一帧在其末尾的音频采集到时凑满，文件模式下所有音频一开始就已就绪
+        const qint64 readyMs = realTime ? qMin<qint64>(audioMs, durationMs) : 0;
+        result.frameLatencyMs << clock.nsecsElapsed() / 1e6 - readyMs;
+    });
+    connections << QObject::connect(&pipeline, &RecognitionPipeline::resultReceived, [&](const RecognitionResult &) {
+        if (result.firstPartialMs < 0) {
+            result.firstPartialMs = clock.nsecsElapsed() / 1e6;
+        }
+    });
+    connections << QObject::connect(&pipeline, &RecognitionPipeline::finalResultReceived, [&]() {
+        result.finalMs = clock.nsecsElapsed() / 1e6;
+        result.ok = true;
+    });
+    connections << QObject::connect(&pipeline, &RecognitionPipeline::errorResponse, [](int code, const QString &message) {
+        qWarning() << "Session failed, code:" << code << "message:" << message;
+    });
+    connections << QObject::connect(&pipeline, &RecognitionPipeline::sessionClosed, &loop, &QEventLoop::quit);
+
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    connections << QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    timeout.start(RUN_TIMEOUT_MS);
+
+    QAudioFormat format;
+    format.setSampleRate(SAMPLE_RATE);
+    format.setChannelCount(1);
+    format.setSampleFormat(QAudioFormat::Int16);
+
+    clock.start();
+    pipeline.startData(pcm, format, realTime);
+    loop.exec();
+
+    for (const QMetaObject::Connection &connection : connections) {
+        QObject::disconnect(connection);
+    }
+    if (!timeout.isActive()) {
+        qWarning() << "Session timed out";
+        result.ok = false;
+    }
+    return result;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("End-to-end latency of the recognition pipeline against a local mock IAT server");
+    parser.addHelpOption();
+
+    const QCommandLineOption runsOption("runs", "Sessions per mode.", "n", "5");
+    const QCommandLineOption latencyOption("latency", "Mock server response delay.", "ms", "50");
+    const QCommandLineOption jitterOption("jitter", "Mock server response jitter.", "ms", "20");
+    const QCommandLineOption modeOption("mode", "realtime, file or both.", "mode", "both");
+    const QCommandLineOption inputOption("input", "16 kHz mono 16-bit PCM file to send.", "file",
+                                         QString(SPEECH_SOURCE_DIR) + "/iat_pcm_16k.pcm");
+    const QCommandLineOption encodingOption("encoding", "Uplink audio encoding: raw, speex-wb or lame.", "name", "raw");
+    const QCommandLineOption frameOption("frame-ms", "Audio per frame in ms, or \"adaptive\".", "ms",
+                                         QString::number(DEFAULT_FRAME_MS));
+    const QCommandLineOption verboseOption({ "v", "verbose" }, "Print pipeline debug output.");
+    parser.addOptions({ runsOption, latencyOption, jitterOption, modeOption, inputOption, encodingOption,
+                        frameOption, verboseOption });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    QFile file(parser.value(inputOption));
+    if (!file.open(QIODevice::ReadOnly)) {
+        err << "Cannot open " << file.fileName() << ": " << file.errorString() << "\n";
+        return 1;
+    }
+    const QByteArray pcm = file.readAll();
+
+    const QString mode = parser.value(modeOption);
+    QList<bool> modes;
+    if (mode == "realtime" || mode == "both") {
+        modes << true;
+    }
+    if (mode == "file" || mode == "both") {
+        modes << false;
+    }
+    if (modes.isEmpty()) {
+        err << "Unknown mode: " << mode << "\n";
+        return 2;
+    }
+
+    AudioEncoding encoding;
+    if (!parseAudioEncoding(parser.value(encodingOption), &encoding) || !audioEncodingSupported(encoding)) {
+        err << "Encoding not available in this build: " << parser.value(encodingOption) << "\n";
+        return 2;
+    }
+
+    MockIatServer::Config config;
+    config.latencyMs = parser.value(latencyOption).toInt();
+    config.jitterMs = parser.value(jitterOption).toInt();
+    MockIatServer server(config);
+    if (!server.listen()) {
+        return 1;
+    }
+
+    // 模拟服务不校验签名，凭据只需非空；关闭 VAD 使帧序号与音频时间一一对应
+    IatCredentials credentials;
+    credentials.appId = "mock";
+    credentials.apiKey = "mock";
+    credentials.apiSecret = "mock";
+    VoiceActivityDetector::Config vadConfig;
+    vadConfig.enabled = false;
+
+    RecognitionPipeline pipeline;
+    pipeline.setEndpoint(server.url());
+    pipeline.setCredentials(credentials);
+    pipeline.setVoiceActivityConfig(vadConfig);
+    pipeline.setAudioEncoding(encoding);
+    const bool adaptive = parser.value(frameOption) == "adaptive";
+    pipeline.setAdaptiveFrameDuration(adaptive);
+    if (!adaptive) {
+        pipeline.setFrameDuration(parser.value(frameOption).toInt());
+    }
+    pipeline.prewarmConnections();
+
+    const int runs = qMax(1, parser.value(runsOption).toInt());
+    const double audioMs = double(pcm.size()) / BYTES_PER_MS;
+    out << QString("audio %1 ms, %2 runs per mode, mock latency %3 ms + jitter %4 ms, encoding %5, frame %6\n\n")
+               .arg(audioMs, 0, 'f', 0)
+               .arg(runs)
+               .arg(config.latencyMs)
+               .arg(config.jitterMs)
+               .arg(QString::fromLatin1(audioEncodingName(encoding)))
+               .arg(adaptive ? QString("adaptive") : QString("%1 ms").arg(pipeline.frameDuration()));
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+               .arg("mode", -10)
+               .arg("frame p50", 10)
+               .arg("frame p95", 10)
+               .arg("frame max", 10)
+               .arg("first ms", 10)
+               .arg("final ms", 10)
+               .arg("after end", 10)
+               .arg("failed", 7);
+    out.flush();
+
+    int exitCode = 0;
+    for (bool realTime : modes) {
+        QList<double> frameLatency;
+        QList<double> firstPartial;
+        QList<double> final;
+        int failed = 0;
+
+        for (int i = 0; i < runs; ++i) {
+            const RunResult result = runOnce(pipeline, server, pcm, realTime);
+            if (!result.ok) {
+                ++failed;
+                continue;
+            }
+            frameLatency += result.frameLatencyMs;
+            if (result.firstPartialMs >= 0) {
+                firstPartial << result.firstPartialMs;
+            }
+            final << result.finalMs;
+        }
+
+        const Summary frames = summarize(frameLatency);
+        const Summary first = summarize(firstPartial);
+        const Summary last = summarize(final);
+        // 实时模式下最终结果相对音频结束时刻的延迟才是用户感知的等待时间
+        const double afterEnd = realTime ? last.p50 - audioMs : last.p50;
+        out << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                   .arg(realTime ? "realtime" : "file", -10)
+                   .arg(frames.p50, 10, 'f', 1)
+                   .arg(frames.p95, 10, 'f', 1)
+                   .arg(frames.max, 10, 'f', 1)
+                   .arg(first.p50, 10, 'f', 1)
+                   .arg(last.p50, 10, 'f', 1)
+                   .arg(afterEnd, 10, 'f', 1)
+                   .arg(failed, 7);
+        out.flush();
+
+        if (failed > 0) {
+            exitCode = 1;
+        }
+    }
+
+    // 上传字节数包含 JSON 包装和 base64 开销，用于比较不同编码的带宽
+    const quint64 sessions = quint64(runs) * quint64(modes.size());
+    out << QString("\nuplink %1 KB per session (%2 kbps)\n")
+               .arg(double(pipeline.metrics()->counter(PipelineMetrics::BytesUploaded)) / sessions / 1024, 0, 'f', 1)
+               .arg(double(pipeline.metrics()->counter(PipelineMetrics::BytesUploaded)) * 8 / sessions / audioMs, 0, 'f', 1);
+
+    return exitCode;
+}
@@ -0,0 +1,39 @@
+#include "benchmarkSuite.h"
+#include "audioLevelMeter.h"
+#include "iatProtocol.h"
+
+#include <QSharedPointer>
+
+#include <cmath>
+
+// 对比原测麦逻辑 (每 100ms 对全部已录音频重新计算) 与滑动窗口电平表
+void registerLevelMeterBenchmarks(BenchmarkSuite &suite)
+{
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+    const qsizetype chunkSize = 100 * BYTES_PER_MS;
+
+    // 原路径：整段录音的累计分析，总开销随录音时长平方增长
+    suite.add("level_meter/recompute_all", pcm.size(), [pcm, chunkSize]() {
+        for (qsizetype end = chunkSize; end <= pcm.size(); end += chunkSize) {
+            const int16_t *samples = reinterpret_cast<const int16_t *>(pcm.constData());
+            const qsizetype sampleCount = end / 2;
+            double rms = 0.0;
+            int16_t maxAmp = 0;
+            for (qsizetype i = 0; i < sampleCount; ++i) {
+                rms += samples[i] * samples[i];
+                maxAmp = qMax(maxAmp, qAbs(samples[i]));
+            }
+            BenchmarkSuite::keep(qint64(std::sqrt(rms / sampleCount)) + maxAmp);
+        }
+    });
+
+    // 新路径：每个样本只处理一次
+    auto meter = QSharedPointer<AudioLevelMeter>::create();
+    suite.add("level_meter/incremental", pcm.size(), [pcm, chunkSize, meter]() {
+        meter->reset();
+        for (qsizetype offset = 0; offset + chunkSize <= pcm.size(); offset += chunkSize) {
+            meter->process(QByteArrayView(pcm.constData() + offset, chunkSize));
+            BenchmarkSuite::keep(qint64(meter->rmsDb()) + meter->peak());
+        }
+    });
+}
@@ -0,0 +1,53 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include <cstdio>
+
+#include "benchmarkSuite.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Microbenchmarks for the audio and protocol hot paths");
+    parser.addHelpOption();
+    parser.addPositionalArgument("filter", "Only run benchmarks whose name contains this text.");
+
+    const QCommandLineOption jsonOption("json", "Also write the results as JSON (usable as a baseline).", "file");
+    const QCommandLineOption baselineOption("baseline", "Fail if any benchmark is slower than this JSON baseline.",
+                                            "file");
+    const QCommandLineOption toleranceOption("tolerance", "Allowed slowdown against the baseline, in percent.",
+                                             "percent", "25");
+    parser.addOptions({ jsonOption, baselineOption, toleranceOption });
+    parser.process(app);
+
+    BenchmarkSuite::RunOptions options;
+    const QStringList args = parser.positionalArguments();
+    options.filter = args.isEmpty() ? QString() : args.first();
+    options.jsonPath = parser.value(jsonOption);
+    options.baselinePath = parser.value(baselineOption);
+
+    bool ok = false;
+    const double tolerance = parser.value(toleranceOption).toDouble(&ok);
+    if (!ok || tolerance < 0) {
+        QTextStream(stderr) << "Invalid --tolerance: " << parser.value(toleranceOption) << "\n";
+        return 2;
+    }
+    options.tolerance = tolerance / 100.0;
+
+    BenchmarkSuite suite;
+    registerFrameWriterBenchmarks(suite);
+    registerBase64Benchmarks(suite);
+    registerVoiceActivityBenchmarks(suite);
+    registerLevelMeterBenchmarks(suite);
+    registerAudioConverterBenchmarks(suite);
+    registerResultParserBenchmarks(suite);
+    registerAudioCodecBenchmarks(suite);
+    registerTranscriptCacheBenchmarks(suite);
+    registerAudioArchiverBenchmarks(suite);
+    registerSessionBenchmarks(suite);
+
+    return suite.run(options);
+}
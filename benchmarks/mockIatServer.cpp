@@ -0,0 +1,232 @@
+#include "mockIatServer.h"
+#include "iatProtocol.h"
+
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QTimer>
+#include <QWebSocket>
+#include <QWebSocketServer>
+#include <QDebug>
+
+namespace {
+// 合成识别结果使用的词表
+const char *const WORDS[] = { "今天", "天气", "很好", "我们", "一起", "去", "公园", "散步", "吧" };
+constexpr int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+// 与真实服务一致的错误码
+constexpr int ERROR_INVALID_PARAMETER = 10106;
+constexpr int ERROR_INVALID_HANDLE = 10165;
+constexpr int ERROR_UNAUTHORIZED = 10313;
+
+// 由上行数据量换算音频时长：raw 为 PCM 字节数，压缩编码按客户端编码器的固定码率
+qint64 audioDurationMs(const QString &encoding, qsizetype bytes)
+{
+    if (encoding == "speex-wb") {
+        return bytes / 70 * 20;  // 质量 8：每 20ms 一包 70 字节
+    }
+    if (encoding == "lame") {
+        return bytes / 4;  // 32 kbps
+    }
+    return bytes / BYTES_PER_MS;
+}
+
+QJsonObject wordsObject(const QString &text, int bg)
+{
+    QJsonObject cw;
+    cw["sc"] = 0;
+    cw["w"] = text;
+    QJsonObject ws;
+    ws["bg"] = bg;
+    ws["cw"] = QJsonArray{ cw };
+    QJsonObject result;
+    result["ws"] = QJsonArray{ ws };
+    return result;
+}
+}
+
+MockIatServer::MockIatServer(QObject *parent)
+    : MockIatServer(Config(), parent)
+{
+}
+
+MockIatServer::MockIatServer(const Config &config, QObject *parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_server(new QWebSocketServer("MockIat", QWebSocketServer::NonSecureMode, this))
+    , m_random(config.seed)
+{
+    m_clock.start();
+    connect(m_server, &QWebSocketServer::newConnection, this, &MockIatServer::onNewConnection);
+}
+
+bool MockIatServer::listen(quint16 port)
+{
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "Mock IAT server failed to listen:" << m_server->errorString();
+        return false;
+    }
+    return true;
+}
+
+QUrl MockIatServer::url() const
+{
+    return QUrl(QString("ws://127.0.0.1:%1/v2/iat").arg(m_server->serverPort()));
+}
+
+void MockIatServer::onNewConnection()
+{
+    while (QWebSocket *socket = m_server->nextPendingConnection()) {
+        ++m_connectionCount;
+        socket->setParent(this);
+        m_sessions.insert(socket, Session());
+
+        connect(socket, &QWebSocket::textMessageReceived, this, [this, socket](const QString &message) {
+            onTextMessage(socket, message);
+        });
+        connect(socket, &QWebSocket::disconnected, this, [this, socket]() {
+            m_sessions.remove(socket);
+            socket->deleteLater();
+        });
+
+        // 真实服务在握手阶段校验签名，这里只检查参数是否齐全
+        const QString query = socket->requestUrl().query();
+        if (!query.contains("authorization=") || !query.contains("date=") || !query.contains("host=")) {
+            sendError(socket, ERROR_UNAUTHORIZED, "missing authorization parameters");
+        }
+    }
+}
+
+void MockIatServer::onTextMessage(QWebSocket *socket, const QString &message)
+{
+    auto it = m_sessions.find(socket);
+    if (it == m_sessions.end()) {
+        return;
+    }
+    Session &session = *it;
+
+    const QJsonObject json = QJsonDocument::fromJson(message.toUtf8()).object();
+    const QJsonObject data = json["data"].toObject();
+    const qsizetype audioBytes = QByteArray::fromBase64(data["audio"].toString().toLatin1()).size();
+    m_audioBytesReceived += audioBytes;
+    if (session.finished) {
+        return;
+    }
+
+    const int status = data["status"].toInt(-1);
+    const QString encoding = data["encoding"].toString();
+    const int sequence = session.frames++;
+    session.frameBeginMs = session.audioMs;
+    session.audioMs += audioDurationMs(encoding, audioBytes);
+    emit frameReceived(sequence, status, session.audioMs);
+
+    // 帧顺序：第一帧 status 0 且带 common/business 参数，之后为 1，最后为 2
+    if (sequence == 0 && (status != 0 || !json.contains("common") || !json.contains("business"))) {
+        sendError(socket, ERROR_INVALID_PARAMETER, "first frame must carry status 0 and common/business");
+        return;
+    }
+    if (sequence > 0 && status != 1 && status != 2) {
+        sendError(socket, ERROR_INVALID_HANDLE, QString("unexpected status %1").arg(status));
+        return;
+    }
+    if (data["format"].toString() != "audio/L16;rate=16000"
+        || (encoding != "raw" && encoding != "speex-wb" && encoding != "lame")) {
+        sendError(socket, ERROR_INVALID_PARAMETER, "unsupported audio format");
+        return;
+    }
+
+    if (m_config.dropAfterFrames > 0 && !m_dropped && session.frames >= m_config.dropAfterFrames) {
+        m_dropped = true;
+        socket->abort();
+        return;
+    }
+
+    if (m_config.errorCode != 0 && session.frames > m_config.errorAfterFrames) {
+        sendError(socket, m_config.errorCode, "injected error");
+        return;
+    }
+
+    // 音频流还没结束就返回最终结果，之后到达的帧不再识别
+    const bool endEarly = m_config.endAfterFrames > 0 && !m_endedEarly && session.frames >= m_config.endAfterFrames;
+    if (endEarly) {
+        m_endedEarly = true;
+    }
+
+    if (status == 2 && m_config.withholdFinal) {
+        session.finished = true;
+        emit sessionFinished(session.frames);
+    } else if (status == 2 || endEarly) {
+        session.finished = true;
+        sendResult(socket, true);
+        emit sessionFinished(session.frames);
+    } else if (session.frames % qMax(1, m_config.partialEvery) == 0) {
+        sendResult(socket, false);
+    }
+}
+
+void MockIatServer::sendError(QWebSocket *socket, int code, const QString &message)
+{
+    m_sessions[socket].finished = true;
+
+    QJsonObject json;
+    json["code"] = code;
+    json["message"] = message;
+    json["sid"] = QString("mock%1").arg(m_connectionCount);
+    sendDelayed(socket, QJsonDocument(json).toJson(QJsonDocument::Compact), true);
+}
+
+void MockIatServer::sendResult(QWebSocket *socket, bool last)
+{
+    Session &session = m_sessions[socket];
+    const int sn = ++session.sn;
+
+    // 合成的词落在最近收到的一帧音频上
+    const QString word = last ? QString("。") : QString(WORDS[(sn - 1) % WORD_COUNT]);
+    QJsonObject result = wordsObject(word, int(session.frameBeginMs / 10));
+    result["sn"] = sn;
+    result["ls"] = last;
+    result["bg"] = 0;
+    result["ed"] = 0;
+
+    // 每隔 replaceEvery 条用 rpl 替换上一条结果，模拟动态修正
+    if (!last && m_config.replaceEvery > 0 && sn > 1 && sn % m_config.replaceEvery == 0) {
+        result["pgs"] = "rpl";
+        result["rg"] = QJsonArray{ sn - 1, sn - 1 };
+    } else {
+        result["pgs"] = "apd";
+    }
+
+    QJsonObject data;
+    data["result"] = result;
+    data["status"] = last ? 2 : 1;
+
+    QJsonObject json;
+    json["code"] = 0;
+    json["message"] = "success";
+    json["sid"] = QString("mock%1").arg(m_connectionCount);
+    json["data"] = data;
+    sendDelayed(socket, QJsonDocument(json).toJson(QJsonDocument::Compact), false);
+}
+
+void MockIatServer::sendDelayed(QWebSocket *socket, const QByteArray &message, bool closeAfter)
+{
+    Session &session = m_sessions[socket];
+    const int jitter = m_config.jitterMs > 0 ? int(m_random.bounded(m_config.jitterMs + 1)) : 0;
+    const qint64 now = m_clock.elapsed();
+
+    // 抖动不能让后一条结果先于前一条发出
+    session.sendAt = qMax(session.sendAt, now + m_config.latencyMs + jitter);
+
+    QPointer<QWebSocket> target(socket);
+    QTimer::singleShot(int(session.sendAt - now), Qt::PreciseTimer, this, [target, message, closeAfter]() {
+        if (!target) {
+            return;
+        }
+        target->sendTextMessage(QString::fromUtf8(message));
+        if (closeAfter) {
+            target->close();
+        }
+    });
+}
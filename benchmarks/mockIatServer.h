@@ -0,0 +1,80 @@
+#ifndef MOCKIATSERVER_H
+#define MOCKIATSERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QUrl>
+
+class QWebSocket;
+class QWebSocketServer;
+
+// 本地模拟的讯飞听写服务，用于离线测试和性能测量
+// 按真实接口校验第一帧/中间帧/结束帧的顺序和字段，返回带 wpgs 动态修正 (apd/rpl) 的合成结果。
+// 每条结果按 latency + [0, jitter] 的延迟发出，同一连接上的结果保持顺序。
+class MockIatServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        int latencyMs = 50;        // 每条结果的基础延迟
+        int jitterMs = 20;         // 额外延迟在 [0, jitterMs] 内均匀分布
+        int partialEvery = 1;      // 每收到几帧音频返回一次中间结果
+        int replaceEvery = 3;      // 每隔几条中间结果用 rpl 修正上一条，0 表示不修正
+        int errorCode = 0;         // 非 0 时在收到 errorAfterFrames 帧后返回该错误码并断开
+        int errorAfterFrames = 0;
+        int dropAfterFrames = 0;   // 非 0 时在第一条连接收到这么多帧后直接断开 (不发关闭帧)，模拟网络中断
+        int endAfterFrames = 0;    // 非 0 时在第一条连接收到这么多帧后返回最终结果，模拟 vad_eos 提前结束会话
+        bool withholdFinal = false;  // 收到结束帧后不返回最终结果也不断开，模拟最终结果迟迟不到
+        quint32 seed = 1;
+    };
+
+    MockIatServer(QObject *parent = nullptr);
+    explicit MockIatServer(const Config &config, QObject *parent = nullptr);
+
+    // port 为 0 时由系统分配
+    bool listen(quint16 port = 0);
+    QUrl url() const;
+
+    // 收到的音频数据总字节数 (解码 base64 之后)，包括会话结束后仍然到达、被忽略的帧
+    qint64 audioBytesReceived() const { return m_audioBytesReceived; }
+
+signals:
+    // 收到第 sequence 帧 (从 0 开始) 时立即发出，status 为帧状态，
+    // audioMs 为本连接截至该帧收到的音频时长 (压缩编码时按码率估算)
+    void frameReceived(int sequence, int status, qint64 audioMs);
+    void sessionFinished(int frames);
+
+private:
+    struct Session
+    {
+        int frames = 0;
+        qint64 audioMs = 0;       // 已收到的音频时长
+        qint64 frameBeginMs = 0;  // 最近一帧音频的起始时间
+        int sn = 0;               // 已发出的结果序号
+        qint64 sendAt = 0;        // 上一条结果计划发出的时间，保证顺序
+        bool finished = false;
+    };
+
+    void onNewConnection();
+    void onTextMessage(QWebSocket *socket, const QString &message);
+    void sendError(QWebSocket *socket, int code, const QString &message);
+    void sendResult(QWebSocket *socket, bool last);
+    void sendDelayed(QWebSocket *socket, const QByteArray &message, bool closeAfter);
+
+    Config m_config;
+    QWebSocketServer *m_server;
+    QHash<QWebSocket *, Session> m_sessions;
+    QRandomGenerator m_random;
+    QElapsedTimer m_clock;
+    int m_connectionCount = 0;
+    bool m_dropped = false;
+    bool m_endedEarly = false;
+    qint64 m_audioBytesReceived = 0;
+};
+
+#endif // MOCKIATSERVER_H
@@ -0,0 +1,54 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include <cstdio>
+
+#include "mockIatServer.h"
+
+// 独立运行的模拟服务，可配合 speech_batch --endpoint 或界面程序手动测试
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Local stand-in for the iFlytek IAT WebSocket service.");
+    parser.addHelpOption();
+
+    const QCommandLineOption portOption("port", "Port to listen on (0 picks a free port).", "port", "0");
+    const QCommandLineOption latencyOption("latency", "Base delay of each response.", "ms", "50");
+    const QCommandLineOption jitterOption("jitter", "Extra random delay of each response.", "ms", "20");
+    const QCommandLineOption partialOption("partial-every", "Send a partial result every N audio frames.", "n", "1");
+    const QCommandLineOption errorCodeOption("error-code", "Reply with this error code and close.", "code", "0");
+    const QCommandLineOption errorAfterOption("error-after", "Frames to accept before the injected error.", "n", "0");
+    const QCommandLineOption dropAfterOption("drop-after", "Abort the first connection after N frames.", "n", "0");
+    const QCommandLineOption endAfterOption("end-after", "End the first session early (like vad_eos) after N frames.",
+                                            "n", "0");
+    parser.addOptions({ portOption, latencyOption, jitterOption, partialOption, errorCodeOption, errorAfterOption,
+                        dropAfterOption, endAfterOption });
+    parser.process(app);
+
+    MockIatServer::Config config;
+    config.latencyMs = parser.value(latencyOption).toInt();
+    config.jitterMs = parser.value(jitterOption).toInt();
+    config.partialEvery = parser.value(partialOption).toInt();
+    config.errorCode = parser.value(errorCodeOption).toInt();
+    config.errorAfterFrames = parser.value(errorAfterOption).toInt();
+    config.dropAfterFrames = parser.value(dropAfterOption).toInt();
+    config.endAfterFrames = parser.value(endAfterOption).toInt();
+
+    MockIatServer server(config);
+    if (!server.listen(quint16(parser.value(portOption).toUInt()))) {
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << "Listening on " << server.url().toString() << "\n";
+    out.flush();
+
+    QObject::connect(&server, &MockIatServer::sessionFinished, [&out](int frames) {
+        out << "Session finished after " << frames << " frames\n";
+        out.flush();
+    });
+    return app.exec();
+}
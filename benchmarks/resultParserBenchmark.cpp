@@ -0,0 +1,153 @@
+#include "benchmarkSuite.h"
+#include "iatResultParser.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSharedPointer>
+
+namespace {
+// 录制的听写服务返回消息，每行一条
+QList<QByteArray> recordedResponses()
+{
+    QList<QByteArray> responses;
+    QFile file(QStringLiteral(SPEECH_SOURCE_DIR "/benchmarks/fixtures/iat_responses.jsonl"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return responses;
+    }
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (!line.isEmpty()) {
+            responses.append(line);
+        }
+    }
+    return responses;
+}
+
+// 参照实现：原先 onTextMessage() 中基于 QJsonDocument 的解析
+bool parseWithDocument(const QString &message, IatResponse &response)
+{
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        return false;
+    }
+
+    const QJsonObject obj = doc.object();
+    const QJsonObject data = obj["data"].toObject();
+    const QJsonObject result = data["result"].toObject();
+    const QJsonArray range = result["rg"].toArray();
+
+    response = IatResponse();
+    response.code = obj["code"].toInt();
+    response.message = obj["message"].toString();
+    response.sid = obj["sid"].toString();
+    response.status = data.contains("status") ? data["status"].toInt() : -1;
+    response.hasResult = result.contains("ws");
+    response.result.sn = result["sn"].toInt();
+    response.result.last = result["ls"].toBool();
+    response.result.replace = result["pgs"].toString() == "rpl";
+    response.result.replaceFirst = range.at(0).toInt();
+    response.result.replaceLast = range.at(1).toInt();
+    for (const QJsonValue &word : result["ws"].toArray()) {
+        if (response.result.beginMs < 0 && word.toObject().contains("bg")) {
+            response.result.beginMs = word.toObject()["bg"].toInt() * 10;
+        }
+        for (const QJsonValue &item : word.toObject()["cw"].toArray()) {
+            response.result.text += item.toObject()["w"].toString();
+        }
+    }
+    return true;
+}
+
+QString describe(const IatResponse &r)
+{
+    return QString("code=%1 message=%2 sid=%3 status=%4 ws=%5 sn=%6 ls=%7 rpl=%8 rg=[%9,%10] bg=%11 text=%12")
+        .arg(r.code).arg(r.message, r.sid).arg(r.status).arg(r.hasResult).arg(r.result.sn)
+        .arg(r.result.last).arg(r.result.replace).arg(r.result.replaceFirst).arg(r.result.replaceLast)
+        .arg(r.result.beginMs).arg(r.result.text);
+}
+
+bool verifyParser(const QList<QByteArray> &responses, QString *error)
+{
+    if (responses.isEmpty()) {
+        *error = "no recorded responses found";
+        return false;
+    }
+
+    IatResultParser parser;
+    IatResponse fromUtf16;
+    IatResponse fromUtf8;
+    IatResponse expected;
+    for (int i = 0; i < responses.size(); ++i) {
+        const QString message = QString::fromUtf8(responses[i]);
+        if (!parseWithDocument(message, expected)) {
+            *error = QString("response %1: reference parse failed").arg(i + 1);
+            return false;
+        }
+        if (!parser.parse(QStringView(message), fromUtf16) || !parser.parse(QByteArrayView(responses[i]), fromUtf8)) {
+            *error = QString("response %1: %2").arg(i + 1).arg(parser.errorString());
+            return false;
+        }
+        const QString want = describe(expected);
+        for (const IatResponse *actual : {&fromUtf16, &fromUtf8}) {
+            const QString got = describe(*actual);
+            if (got != want) {
+                *error = QString("response %1: expected %2, got %3").arg(i + 1).arg(want, got);
+                return false;
+            }
+        }
+    }
+
+    // 残缺的消息必须报错而不是越界读取
+    const QByteArray truncated = responses.first().left(responses.first().size() / 2);
+    if (parser.parse(QByteArrayView(truncated), fromUtf8)) {
+        *error = "truncated response was accepted";
+        return false;
+    }
+    return true;
+}
+}
+
+// 每条识别结果都在网络线程上解析，开销随并发流数线性增长
+void registerResultParserBenchmarks(BenchmarkSuite &suite)
+{
+    const QList<QByteArray> responses = recordedResponses();
+    suite.addCheck("iat_parse/matches_qjson", [responses](QString *error) {
+        return verifyParser(responses, error);
+    });
+
+    QStringList messages;
+    qint64 totalBytes = 0;
+    for (const QByteArray &response : responses) {
+        messages.append(QString::fromUtf8(response));
+        totalBytes += response.size();
+    }
+
+    // 参照：原先的 toUtf8() + QJsonDocument 解析
+    suite.add("iat_parse/qjson_document", totalBytes, [messages]() {
+        IatResponse response;
+        for (const QString &message : messages) {
+            parseWithDocument(message, response);
+            BenchmarkSuite::keep(response.result.text.size());
+        }
+    });
+
+    // IatClient 的实际路径：直接扫描 QWebSocket 给出的 UTF-16 文本，输出结构复用
+    auto parser = QSharedPointer<IatResultParser>::create();
+    auto response = QSharedPointer<IatResponse>::create();
+    suite.add("iat_parse/streaming_utf16", totalBytes, [messages, parser, response]() {
+        for (const QString &message : messages) {
+            parser->parse(QStringView(message), *response);
+            BenchmarkSuite::keep(response->result.text.size());
+        }
+    });
+
+    suite.add("iat_parse/streaming_utf8", totalBytes, [responses, parser, response]() {
+        for (const QByteArray &message : responses) {
+            parser->parse(QByteArrayView(message), *response);
+            BenchmarkSuite::keep(response->result.text.size());
+        }
+    });
+}
@@ -0,0 +1,172 @@
+#include "benchmarkSuite.h"
+#include "mockIatServer.h"
+#include "recognitionPipeline.h"
+
+#include <QEventLoop>
+#include <QTimer>
+
+namespace {
+constexpr int SESSION_TIMEOUT_MS = 30000;
+
+struct SessionOutcome
+{
+    bool finalReceived = false;
+    bool inputFinished = false;
+    bool timedOut = false;
+    int errorCode = 0;
+    QString errorMessage;
+    int sessionsOpened = 0;  // 服务端收到的第一帧数，即会话 (分段) 数
+};
+
+// 对接模拟服务运行一次文件识别，直到会话结束；stopAfterMs >= 0 时按实时节拍送入，到时提前停止
+SessionOutcome runSession(const MockIatServer::Config &config, const QByteArray &pcm, qint64 *audioBytesReceived,
+                          int stopAfterMs = -1)
+{
+    SessionOutcome outcome;
+    MockIatServer server(config);
+    if (!server.listen()) {
+        outcome.errorCode = -1;
+        outcome.errorMessage = "mock server failed to listen";
+        return outcome;
+    }
+
+    // 模拟服务不校验签名，凭据只需非空；关闭 VAD 使发出的音频与输入一一对应
+    IatCredentials credentials;
+    credentials.appId = "mock";
+    credentials.apiKey = "mock";
+    credentials.apiSecret = "mock";
+    VoiceActivityDetector::Config vadConfig;
+    vadConfig.enabled = false;
+
+    RecognitionPipeline pipeline;
+    pipeline.setEndpoint(server.url());
+    pipeline.setCredentials(credentials);
+    pipeline.setVoiceActivityConfig(vadConfig);
+
+    QEventLoop loop;
+    QObject::connect(&server, &MockIatServer::frameReceived, [&outcome](int sequence, int, qint64) {
+        if (sequence == 0) {
+            ++outcome.sessionsOpened;
+        }
+    });
+    QObject::connect(&pipeline, &RecognitionPipeline::finalResultReceived, [&outcome]() {
+        outcome.finalReceived = true;
+    });
+    QObject::connect(&pipeline, &RecognitionPipeline::inputFinished, [&outcome]() {
+        outcome.inputFinished = true;
+    });
+    QObject::connect(&pipeline, &RecognitionPipeline::errorResponse, [&outcome](int code, const QString &message) {
+        outcome.errorCode = code;
+        outcome.errorMessage = message;
+    });
+    QObject::connect(&pipeline, &RecognitionPipeline::sessionClosed, &loop, &QEventLoop::quit);
+
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    QObject::connect(&timeout, &QTimer::timeout, &loop, [&outcome, &loop]() {
+        outcome.timedOut = true;
+        loop.quit();
+    });
+    timeout.start(SESSION_TIMEOUT_MS);
+
+    QAudioFormat format;
+    format.setSampleRate(SAMPLE_RATE);
+    format.setChannelCount(1);
+    format.setSampleFormat(QAudioFormat::Int16);
+    pipeline.startData(pcm, format, stopAfterMs >= 0);
+    if (stopAfterMs >= 0) {
+        QTimer::singleShot(stopAfterMs, &pipeline, &RecognitionPipeline::stop);
+    }
+    loop.exec();
+
+    *audioBytesReceived = server.audioBytesReceived();
+    return outcome;
+}
+
+// 服务端在音频流结束之前返回最终结果 (vad_eos)：已排队的帧接着发往新一段，
+// 每一段音频都恰好发出一次。服务端结束时正在途中的帧同样计入，它们是否被识别不由客户端决定
+bool verifyEarlySegmentEnd(QString *error)
+{
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+    MockIatServer::Config config;
+    config.latencyMs = 0;
+    config.jitterMs = 0;
+    config.endAfterFrames = 10;
+
+    qint64 received = 0;
+    const SessionOutcome outcome = runSession(config, pcm, &received);
+    if (outcome.timedOut || outcome.errorCode != 0 || !outcome.finalReceived) {
+        *error = QString("session did not finish cleanly (code %1: %2)").arg(outcome.errorCode).arg(outcome.errorMessage);
+        return false;
+    }
+    if (!outcome.inputFinished) {
+        *error = "pipeline did not report the input as finished";
+        return false;
+    }
+    if (outcome.sessionsOpened < 2) {
+        *error = "the service did not end the first session early";
+        return false;
+    }
+    if (received != pcm.size()) {
+        *error = QString("service received %1 audio bytes, expected %2").arg(received).arg(pcm.size());
+        return false;
+    }
+    return true;
+}
+
+// 文件识别被中途停止时会话照常以最终结果结束，但不能报告输入已读完：
+// 界面和批量转写据此不把截断的结果写入整个文件的缓存
+bool verifyStoppedInput(QString *error)
+{
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+    MockIatServer::Config config;
+    config.latencyMs = 0;
+    config.jitterMs = 0;
+
+    qint64 received = 0;
+    const SessionOutcome outcome = runSession(config, pcm, &received, 500);
+    if (outcome.timedOut || outcome.errorCode != 0 || !outcome.finalReceived) {
+        *error = QString("stopped session did not finish cleanly (code %1: %2)").arg(outcome.errorCode).arg(outcome.errorMessage);
+        return false;
+    }
+    if (received >= pcm.size()) {
+        *error = "the whole file was sent before the stop";
+        return false;
+    }
+    if (outcome.inputFinished) {
+        *error = "a stopped file input was reported as finished";
+        return false;
+    }
+    return true;
+}
+}
+
+// 结束帧发出后最终结果一直不到：等待超时后会话以错误结束，调用方不会把缺少结尾的文本当作完整结果
+bool verifyMissingFinal(QString *error)
+{
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+    MockIatServer::Config config;
+    config.latencyMs = 0;
+    config.jitterMs = 0;
+    config.withholdFinal = true;
+
+    qint64 received = 0;
+    const SessionOutcome outcome = runSession(config, pcm, &received);
+    if (outcome.timedOut) {
+        *error = "session did not close after the final result timed out";
+        return false;
+    }
+    if (outcome.finalReceived || outcome.errorCode == 0) {
+        *error = "a session without a final result was not reported as an error";
+        return false;
+    }
+    return true;
+}
+
+// 会话级的行为校验：识别流水线对接本地模拟服务
+void registerSessionBenchmarks(BenchmarkSuite &suite)
+{
+    suite.addCheck("session/early_end_keeps_audio", verifyEarlySegmentEnd);
+    suite.addCheck("session/stopped_input_not_finished", verifyStoppedInput);
+    suite.addCheck("session/missing_final_reported", verifyMissingFinal);
+}
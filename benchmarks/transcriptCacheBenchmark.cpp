@@ -0,0 +1,232 @@
+#include "benchmarkSuite.h"
+#include "transcriptCache.h"
+#include "audioFileSource.h"
+#include "iatProtocol.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSharedPointer>
+#include <QTemporaryDir>
+#include <QUrl>
+
+namespace {
+const QString SAMPLE_TEXT = QStringLiteral("科大讯飞是中国最大的智能语音技术提供商。");
+
+QAudioFormat pcmFormat()
+{
+    QAudioFormat format;
+    format.setSampleRate(SAMPLE_RATE);
+    format.setChannelCount(1);
+    format.setSampleFormat(QAudioFormat::Int16);
+    return format;
+}
+
+QByteArray keyOf(const QByteArray &pcm, const QAudioFormat &format, AudioEncoding encoding = AudioEncoding::Raw,
+                 const QUrl &endpoint = QUrl(QString(IAT_ENDPOINT)))
+{
+    AudioFileSource source;
+    source.openData(pcm, format);
+    return TranscriptCache::key(source, encoding, endpoint);
+}
+
+bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+// 写入、命中、重新打开后仍能命中；内容、格式、上行编码或服务地址不同时不命中
+bool verifyRoundTrip(QString *error)
+{
+    QTemporaryDir dir;
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+    const QByteArray key = keyOf(pcm, pcmFormat());
+
+    QAudioFormat otherRate = pcmFormat();
+    otherRate.setSampleRate(8000);
+    QByteArray otherPcm = pcm;
+    otherPcm[otherPcm.size() / 2] = char(otherPcm[otherPcm.size() / 2] ^ 1);
+    if (keyOf(pcm, otherRate) == key || keyOf(otherPcm, pcmFormat()) == key) {
+        *error = "different audio produced the same key";
+        return false;
+    }
+    if (keyOf(pcm, pcmFormat(), AudioEncoding::Raw, QUrl("ws://127.0.0.1:1/v2/iat")) == key) {
+        *error = "a different endpoint produced the same key";
+        return false;
+    }
+    for (AudioEncoding encoding : { AudioEncoding::SpeexWb, AudioEncoding::Lame }) {
+        // 构建时不支持的编码按 raw 发送，键也应相同
+        const bool same = keyOf(pcm, pcmFormat(), encoding) == key;
+        if (same == audioEncodingSupported(encoding)) {
+            *error = QString("encoding %1 %2 the raw key").arg(QString::fromLatin1(audioEncodingName(encoding)),
+                                                               same ? "shares" : "differs from");
+            return false;
+        }
+    }
+
+    {
+        TranscriptCache cache(dir.path());
+        if (!cache.open(error)) {
+            return false;
+        }
+        QString text;
+        if (cache.lookup(key, &text)) {
+            *error = "empty cache reported a hit";
+            return false;
+        }
+        cache.insert(key, SAMPLE_TEXT);
+    }
+
+    TranscriptCache reopened(dir.path());
+    if (!reopened.open(error)) {
+        return false;
+    }
+    QString text;
+    if (!reopened.lookup(key, &text) || text != SAMPLE_TEXT) {
+        *error = QString("lookup after reopen returned \"%1\"").arg(text);
+        return false;
+    }
+    if (reopened.entryCount() != 1 || reopened.totalBytes() != SAMPLE_TEXT.toUtf8().size()) {
+        *error = QString("%1 entries / %2 bytes after one insert").arg(reopened.entryCount()).arg(reopened.totalBytes());
+        return false;
+    }
+    return true;
+}
+
+// 超过上限时淘汰最久未用的条目，刚命中过的条目保留
+bool verifyEviction(QString *error)
+{
+    QTemporaryDir dir;
+    const qint64 entryBytes = SAMPLE_TEXT.toUtf8().size();
+    TranscriptCache cache(dir.path(), entryBytes * 3);
+    if (!cache.open(error)) {
+        return false;
+    }
+
+    QList<QByteArray> keys;
+    for (int i = 0; i < 4; ++i) {
+        keys.append(keyOf(QByteArray::number(i).repeated(64), pcmFormat()));
+    }
+    cache.insert(keys[0], SAMPLE_TEXT);
+    cache.insert(keys[1], SAMPLE_TEXT);
+    cache.insert(keys[2], SAMPLE_TEXT);
+    QString text;
+    cache.lookup(keys[0], &text);
+    cache.insert(keys[3], SAMPLE_TEXT);
+
+    if (cache.lookup(keys[1], &text)) {
+        *error = "least recently used entry was not evicted";
+        return false;
+    }
+    if (!cache.lookup(keys[0], &text) || !cache.lookup(keys[3], &text)) {
+        *error = "recently used entry was evicted";
+        return false;
+    }
+    if (cache.totalBytes() > entryBytes * 3) {
+        *error = QString("%1 bytes exceed the %2 byte limit").arg(cache.totalBytes()).arg(entryBytes * 3);
+        return false;
+    }
+    return true;
+}
+
+// 长录音的键在线程池中另行打开文件计算，结果必须与同步计算的相同，否则永远不会命中
+bool verifyAsyncKey(QString *error)
+{
+    QTemporaryDir dir;
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+    const QString path = QDir(dir.path()).filePath("sample.pcm");
+    if (!writeFile(path, pcm)) {
+        *error = QString("cannot write %1").arg(path);
+        return false;
+    }
+
+    const QUrl endpoint(QString::fromLatin1(IAT_ENDPOINT));
+    const QByteArray key = TranscriptCache::keyAsync(path, pcmFormat(), AudioEncoding::Raw, endpoint).result();
+    if (key != keyOf(pcm, pcmFormat())) {
+        *error = "keyAsync() and key() disagree";
+        return false;
+    }
+    if (!TranscriptCache::keyAsync(QDir(dir.path()).filePath("missing.pcm"), pcmFormat(), AudioEncoding::Raw,
+                                   endpoint).result().isEmpty()) {
+        *error = "keyAsync() returned a key for a missing file";
+        return false;
+    }
+    return true;
+}
+
+// 索引损坏而重建时只清理缓存自己的条目：缓存目录和子目录中的其他文件原样保留
+bool verifyResetKeepsForeignFiles(QString *error)
+{
+    QTemporaryDir dir;
+    const QByteArray key = keyOf(BenchmarkSuite::samplePcm(), pcmFormat());
+    {
+        TranscriptCache cache(dir.path());
+        if (!cache.open(error)) {
+            return false;
+        }
+        cache.insert(key, SAMPLE_TEXT);
+    }
+
+    const QDir store(QDir(dir.path()).filePath("transcript-cache"));
+    const QStringList foreign = { QDir(dir.path()).filePath("notes.txt"), store.filePath("notes.txt"),
+                                  store.filePath("readme.transcript") };
+    for (const QString &path : foreign) {
+        if (!writeFile(path, "keep")) {
+            *error = QString("cannot write %1").arg(path);
+            return false;
+        }
+    }
+    if (!writeFile(store.filePath("index.bin"), "corrupt")) {
+        *error = "cannot corrupt the index";
+        return false;
+    }
+
+    TranscriptCache reopened(dir.path());
+    if (!reopened.open(error)) {
+        return false;
+    }
+    QString text;
+    if (reopened.lookup(key, &text) || reopened.entryCount() != 0) {
+        *error = "entries survived an index reset";
+        return false;
+    }
+    if (!store.entryList({ "*.transcript" }, QDir::Files).contains("readme.transcript")
+        || store.entryList({ "*.transcript" }, QDir::Files).size() != 1) {
+        *error = "index reset left cache entries or removed a foreign .transcript file";
+        return false;
+    }
+    for (const QString &path : foreign) {
+        if (!QFile::exists(path)) {
+            *error = QString("index reset deleted %1").arg(path);
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+// 键的计算要读完整段音频，需要远快于上传；命中路径只有一次索引查找和一次小文件读取
+void registerTranscriptCacheBenchmarks(BenchmarkSuite &suite)
+{
+    suite.addCheck("cache/round_trip", verifyRoundTrip);
+    suite.addCheck("cache/eviction", verifyEviction);
+    suite.addCheck("cache/reset_keeps_foreign_files", verifyResetKeepsForeignFiles);
+    suite.addCheck("cache/async_key", verifyAsyncKey);
+
+    const QByteArray pcm = BenchmarkSuite::samplePcm();
+    suite.add("cache/key", pcm.size(), [pcm]() {
+        BenchmarkSuite::keep(keyOf(pcm, pcmFormat()).size());
+    });
+
+    QSharedPointer<QTemporaryDir> dir(new QTemporaryDir);
+    QSharedPointer<TranscriptCache> cache(new TranscriptCache(dir->path()));
+    if (!cache->open()) {
+        return;
+    }
+    const QByteArray key = keyOf(pcm, pcmFormat());
+    cache->insert(key, SAMPLE_TEXT);
+    suite.add("cache/lookup_hit", 0, [dir, cache, key]() {
+        QString text;
+        BenchmarkSuite::keep(cache->lookup(key, &text) ? text.size() : 0);
+    });
+}
@@ -0,0 +1,26 @@
+#include "benchmarkSuite.h"
+#include "audioKernels.h"
+#include "voiceActivityDetector.h"
+
+#include <QSharedPointer>
+
+// 语音活动检测每帧都在预处理线程上运行，需要远快于实时
+void registerVoiceActivityBenchmarks(BenchmarkSuite &suite)
+{
+    const QByteArray frame = BenchmarkSuite::samplePcmFrame();
+    const qint16 *samples = reinterpret_cast<const qint16 *>(frame.constData());
+    const qsizetype sampleCount = frame.size() / 2;
+
+    suite.add("vad/sum_of_squares", frame.size(), [frame, samples, sampleCount]() {
+        BenchmarkSuite::keep(qint64(audioSumOfSquares(samples, sampleCount)));
+    });
+
+    suite.add("vad/zero_crossings", frame.size(), [frame, samples, sampleCount]() {
+        BenchmarkSuite::keep(audioZeroCrossings(samples, sampleCount));
+    });
+
+    auto vad = QSharedPointer<VoiceActivityDetector>::create();
+    suite.add("vad/analyze_frame", frame.size(), [frame, vad]() {
+        BenchmarkSuite::keep(vad->analyzeFrame(frame));
+    });
+}
@@ -0,0 +1,138 @@
+#include "frameEncoder.h"
+#include "pipelineMetrics.h"
+
+#include <QDebug>
+
+FrameEncoder::FrameEncoder(SpscQueue<AudioFrame> *input, SpscQueue<EncodedFrame> *output,
+                           SpscQueue<QByteArray> *recycled, QObject *parent)
+    : PipelineStage(parent)
+    , m_input(input)
+    , m_output(output)
+    , m_recycled(recycled)
+    , m_codec(createAudioCodec(AudioEncoding::Raw))
+{
+}
+
+void FrameEncoder::reset()
+{
+    m_input->clear();
+    m_codec->reset();
+    m_firstFrame = true;
+    m_segmentIndex = 0;
+}
+
+void FrameEncoder::restartSegment()
+{
+    if (m_firstFrame) {
+        return;
+    }
+    // 旧会话已经结束，压缩编码器的尾部数据不再发送
+    m_codec->reset();
+    m_firstFrame = true;
+    ++m_segmentIndex;
+    qDebug() << "Restarting at segment" << m_segmentIndex;
+}
+
+void FrameEncoder::setEncoding(AudioEncoding encoding)
+{
+    if (m_codec->encoding() == encoding) {
+        return;
+    }
+
+    std::unique_ptr<AudioCodec> codec = createAudioCodec(encoding);
+    if (!codec) {
+        qDebug() << "Audio encoding" << audioEncodingName(encoding) << "is not available in this build, using raw";
+        codec = createAudioCodec(AudioEncoding::Raw);
+    }
+    m_codec = std::move(codec);
+    m_writer.setEncoding(audioEncodingName(m_codec->encoding()));
+}
+
+void FrameEncoder::process()
+{
+    bool produced = false;
+    bool consumed = false;
+
+    // 最后一帧同时也是第一帧时需要两个输出槽位，统一按两个预留
+    while (m_output->freeSlots() >= 2) {
+        AudioFrame frame;
+        if (!m_input->pop(frame)) {
+            break;
+        }
+        consumed = true;
+
+        // 音频流结束和分段结束都以结束帧收尾
+        const bool ends = frame.last || frame.segmentEnd;
+        EncodedFrame encoded;
+        if (m_firstFrame && frame.last && frame.pcm.isEmpty()) {
+            // 音频流在两段之间结束 (如听音模式下无人说话时停止)：没有要发送的消息，只转发结束标记
+            encoded.last = true;
+            encoded.emittedAtNs = PipelineMetrics::now();
+            m_output->push(std::move(encoded));
+        } else if (m_firstFrame) {
+            encoded.message = encodeFrame(STATUS_FIRST_FRAME, frame.pcm);
+            encoded.first = true;
+            encoded.overlap = frame.overlap;
+            stamp(encoded, frame);
+            m_firstFrame = false;
+            qDebug() << "Encoded first frame of segment" << m_segmentIndex << "message size:" << encoded.message.size();
+            m_output->push(std::move(encoded));
+
+            if (ends) {
+                // 第一帧即为最后一帧：音频已随第一帧发出，再补一个空的结束帧
+                EncodedFrame endFrame;
+                endFrame.message = encodeFrame(STATUS_LAST_FRAME, QByteArray());
+                endFrame.last = frame.last;
+                endFrame.segmentEnd = frame.segmentEnd;
+                endFrame.emittedAtNs = PipelineMetrics::now();
+                m_output->push(std::move(endFrame));
+            }
+        } else {
+            encoded.message = encodeFrame(ends ? STATUS_LAST_FRAME : STATUS_CONTINUE_FRAME, frame.pcm);
+            encoded.last = frame.last;
+            encoded.segmentEnd = frame.segmentEnd;
+            stamp(encoded, frame);
+            m_output->push(std::move(encoded));
+        }
+
+        if (frame.segmentEnd && !frame.last) {
+            // 下一帧开始新会话，压缩编码器从头开始
+            m_codec->reset();
+            m_firstFrame = true;
+            ++m_segmentIndex;
+        }
+        produced = true;
+    }
+
+    if (produced && m_downstream) {
+        m_downstream->wake();
+    }
+    if (consumed && m_upstream) {
+        m_upstream->wake();
+    }
+}
+
+void FrameEncoder::stamp(EncodedFrame &encoded, const AudioFrame &frame)
+{
+    encoded.capturedAtNs = frame.capturedAtNs;
+    encoded.audioMs = int(frame.pcm.size() / BYTES_PER_MS);
+    encoded.emittedAtNs = PipelineMetrics::now();
+    if (m_metrics) {
+        m_metrics->record(PipelineMetrics::CaptureToEmit, encoded.capturedAtNs, encoded.emittedAtNs);
+    }
+}
+
+QByteArray FrameEncoder::encodeFrame(FrameStatus status, const QByteArray &pcm)
+{
+    // 压缩编码的状态跨帧延续，最后一帧时冲刷编码器缓存的尾部数据
+    const QByteArrayView audio = m_codec->encode(pcm, status == STATUS_LAST_FRAME);
+
+    // 优先复用网络阶段归还的缓冲区
+    QByteArray message;
+    if (!m_recycled->pop(message)) {
+        message.reserve(m_writer.maxFrameSize(m_codec->maxEncodedSize(pcm.size())));
+    }
+
+    m_writer.writeFrame(message, status, audio);
+    return message;
+}
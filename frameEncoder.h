@@ -0,0 +1,58 @@
+#ifndef FRAMEENCODER_H
+#define FRAMEENCODER_H
+
+#include "pipelineStage.h"
+#include "spscQueue.h"
+#include "iatProtocol.h"
+#include "iatFrameWriter.h"
+#include "audioCodec.h"
+
+#include <memory>
+
+// 编码阶段：按所选编码压缩 PCM 帧 (默认不压缩)，再编码为 base64 并组装成 IAT JSON 消息
+// 分段结束的帧编码为结束帧，下一帧重新作为第一帧 (带 common/business 参数) 开始新会话；
+// 分段结束之后紧接着音频流结束时不再开始新会话，只向网络阶段转发一个空的结束标记。
+// 消息缓冲区由网络阶段发送后通过 recycled 队列归还，稳定运行时不再分配内存。
+class FrameEncoder : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    FrameEncoder(SpscQueue<AudioFrame> *input, SpscQueue<EncodedFrame> *output,
+                 SpscQueue<QByteArray> *recycled, QObject *parent = nullptr);
+
+    void setUpstream(PipelineStage *stage) { m_upstream = stage; }
+    void setDownstream(PipelineStage *stage) { m_downstream = stage; }
+
+public slots:
+    // 开始新会话前在本线程中清空输入队列
+    void reset();
+
+    // 在本阶段线程中调用
+    void setAppId(const QString &appId) { m_writer.setAppId(appId); }
+    // 构建时未包含的编码退回 raw；在 reset() 之前调用
+    void setEncoding(AudioEncoding encoding);
+    // 服务端提前结束了当前会话：下一帧作为新一段的第一帧编码
+    void restartSegment();
+
+protected:
+    void process() override;
+
+private:
+    QByteArray encodeFrame(FrameStatus status, const QByteArray &pcm);
+    // 记录帧的采集和编码时间戳
+    void stamp(EncodedFrame &encoded, const AudioFrame &frame);
+
+    SpscQueue<AudioFrame> *m_input;
+    SpscQueue<EncodedFrame> *m_output;
+    SpscQueue<QByteArray> *m_recycled;
+    IatFrameWriter m_writer;
+    std::unique_ptr<AudioCodec> m_codec;
+    PipelineStage *m_upstream = nullptr;
+    PipelineStage *m_downstream = nullptr;
+
+    bool m_firstFrame = true;
+    int m_segmentIndex = 0;
+};
+
+#endif // FRAMEENCODER_H
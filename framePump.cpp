@@ -0,0 +1,84 @@
+#include "framePump.h"
+
+FramePump::FramePump(QObject *parent)
+    : QObject(parent)
+{
+    m_deadlineTimer.setSingleShot(true);
+    m_deadlineTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_deadlineTimer, &QTimer::timeout, this, &FramePump::schedule);
+}
+
+void FramePump::setSocket(QWebSocket *socket)
+{
+    if (m_socket) {
+        disconnect(m_socket, &QWebSocket::bytesWritten, this, &FramePump::schedule);
+    }
+    m_socket = socket;
+    if (m_socket) {
+        connect(m_socket, &QWebSocket::bytesWritten, this, &FramePump::schedule);
+    }
+}
+
+void FramePump::setFrameSource(FrameAvailable hasFrame, SendFrame sendFrame)
+{
+    m_hasFrame = std::move(hasFrame);
+    m_sendFrame = std::move(sendFrame);
+}
+
+void FramePump::start(qint64 streamElapsedMs)
+{
+    m_audioSentMs = 0;
+    m_clock.start();
+    m_clockOffset = streamElapsedMs;
+    m_active = true;
+    schedule();
+}
+
+void FramePump::stop()
+{
+    m_active = false;
+    m_deadlineTimer.stop();
+}
+
+void FramePump::resume()
+{
+    m_yielded = false;
+    schedule();
+}
+
+void FramePump::schedule()
+{
+    if (!m_active || m_pumping || m_yielded || !m_hasFrame || !m_sendFrame) {
+        return;
+    }
+
+    m_pumping = true;
+    int sentThisTurn = 0;
+    while (m_active && m_hasFrame()) {
+        if (m_maxFramesPerTurn > 0 && sentThisTurn >= m_maxFramesPerTurn) {
+            // 排到事件队列末尾，先处理同一线程上其他会话已经排队的事件
+            m_yielded = true;
+            QMetaObject::invokeMethod(this, &FramePump::resume, Qt::QueuedConnection);
+            break;
+        }
+
+        // 背压：socket 还有大量数据未写出时先不发送，等待 bytesWritten
+        if (m_socket && m_socket->bytesToWrite() > m_maxPendingBytes) {
+            break;
+        }
+
+        if (m_pacing == RealTimePacing) {
+            const qint64 wait = m_audioSentMs - (m_clock.elapsed() + m_clockOffset);
+            if (wait > 0) {
+                if (!m_deadlineTimer.isActive()) {
+                    m_deadlineTimer.start(int(wait));
+                }
+                break;
+            }
+        }
+
+        m_audioSentMs += m_sendFrame();
+        ++sentThisTurn;
+    }
+    m_pumping = false;
+}
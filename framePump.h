@@ -0,0 +1,73 @@
+#ifndef FRAMEPUMP_H
+#define FRAMEPUMP_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QWebSocket>
+
+#include <functional>
+
+// 事件驱动的帧发送调度器
+// 由数据到达 (readyRead) 和 socket 可写 (bytesWritten) 触发，不再定时轮询。
+// RealTimePacing：已发出的音频时长不超过音频流已经持续的时间，帧长可以逐帧变化，实时采集时数据一到就发；
+// MaxThroughputPacing：只受 socket 发送积压限制，用于文件输入。
+class FramePump : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Pacing {
+        RealTimePacing,
+        MaxThroughputPacing
+    };
+    Q_ENUM(Pacing)
+
+    using FrameAvailable = std::function<bool()>;
+    using SendFrame = std::function<int()>;  // 发出一帧，返回其音频时长 (毫秒)
+
+    explicit FramePump(QObject *parent = nullptr);
+
+    void setPacing(Pacing pacing) { m_pacing = pacing; }
+    Pacing pacing() const { return m_pacing; }
+
+    void setMaxPendingBytes(qint64 bytes) { m_maxPendingBytes = bytes; }
+    // 一次调度最多连续发送的帧数，0 表示不限；多个会话共用线程时，
+    // 达到上限后重新排队，让同一线程上的其他会话轮流发送
+    void setMaxFramesPerTurn(int frames) { m_maxFramesPerTurn = frames; }
+
+    // 发送积压超过 maxPendingBytes 时暂停，收到 bytesWritten 后继续
+    void setSocket(QWebSocket *socket);
+    void setFrameSource(FrameAvailable hasFrame, SendFrame sendFrame);
+
+    // streamElapsedMs：音频流在此之前已经持续的时间，连接期间积压的帧因此可以立即发出
+    void start(qint64 streamElapsedMs = 0);
+    void stop();
+    bool isActive() const { return m_active; }
+
+public slots:
+    void schedule();
+
+private slots:
+    void resume();
+
+private:
+    Pacing m_pacing = RealTimePacing;
+    qint64 m_maxPendingBytes = 64 * 1024;
+    int m_maxFramesPerTurn = 0;
+
+    QPointer<QWebSocket> m_socket;
+    FrameAvailable m_hasFrame;
+    SendFrame m_sendFrame;
+
+    QTimer m_deadlineTimer;  // 实时节拍下，数据早于发送时间到达时才启动
+    QElapsedTimer m_clock;
+    qint64 m_clockOffset = 0;
+    qint64 m_audioSentMs = 0;  // 已发出的音频时长
+    bool m_active = false;
+    bool m_pumping = false;  // 防止 sendFrame 内部再次触发 schedule() 造成重入
+    bool m_yielded = false;  // 已让出线程，排队的 schedule() 尚未执行
+};
+
+#endif // FRAMEPUMP_H
@@ -0,0 +1,73 @@
+#include "iatAuth.h"
+
+#include <QLocale>
+#include <QMessageAuthenticationCode>
+
+IatAuth::IatAuth(const IatCredentials &credentials, const QUrl &endpoint)
+    : m_credentials(credentials)
+    , m_endpoint(endpoint)
+{
+}
+
+void IatAuth::setCredentials(const IatCredentials &credentials)
+{
+    if (credentials != m_credentials) {
+        m_credentials = credentials;
+        m_cachedUrl.clear();
+    }
+}
+
+void IatAuth::setEndpoint(const QUrl &endpoint)
+{
+    if (endpoint != m_endpoint) {
+        m_endpoint = endpoint;
+        m_cachedUrl.clear();
+    }
+}
+
+QUrl IatAuth::signedUrl(const QDateTime &nowUtc)
+{
+    if (!m_cachedUrl.isEmpty() && m_signedAt <= nowUtc
+        && m_signedAt.secsTo(nowUtc) < SIGNATURE_REUSE_SECS) {
+        return m_cachedUrl;
+    }
+
+    const QString date = httpDate(nowUtc);
+
+    // 签名和日期都含有 '+'、'=' 和空格等字符，需要完整地百分号编码
+    QByteArray url = m_endpoint.toString(QUrl::RemoveQuery).toUtf8();
+    url += "?authorization=" + QUrl::toPercentEncoding(QString::fromLatin1(authorization(date)));
+    url += "&date=" + QUrl::toPercentEncoding(date);
+    url += "&host=" + QUrl::toPercentEncoding(m_endpoint.host());
+
+    m_cachedUrl = QUrl::fromEncoded(url);
+    m_signedAt = nowUtc;
+    return m_cachedUrl;
+}
+
+QString IatAuth::httpDate(const QDateTime &utc)
+{
+    // 固定使用 C locale，避免星期和月份被本地化
+    return QLocale::c().toString(utc.toUTC(), "ddd, dd MMM yyyy HH:mm:ss") + " GMT";
+}
+
+QByteArray IatAuth::authorization(const QString &date) const
+{
+    // 生成HMAC-SHA256签名
+    const QString signStr = QString("host: %1\n"
+                                    "date: %2\n"
+                                    "GET %3 HTTP/1.1")
+                                .arg(m_endpoint.host(), date, m_endpoint.path());
+
+    const QByteArray signature = QMessageAuthenticationCode::hash(
+                                     signStr.toUtf8(),
+                                     m_credentials.apiSecret.toUtf8(),
+                                     QCryptographicHash::Sha256
+                                     ).toBase64();
+
+    const QString authStr = QString(R"(api_key="%1", algorithm="hmac-sha256", )"
+                                    R"(headers="host date request-line", signature="%2")")
+                                .arg(m_credentials.apiKey, QString::fromLatin1(signature));
+
+    return authStr.toUtf8().toBase64();
+}
@@ -0,0 +1,43 @@
+#ifndef IATAUTH_H
+#define IATAUTH_H
+
+#include <QDateTime>
+#include <QString>
+#include <QUrl>
+
+#include "iatCredentials.h"
+
+// 讯飞接口的握手鉴权
+// 对 "host / date / request-line" 做 HMAC-SHA256 签名，签名和日期作为 URL 参数传给服务端。
+// 每次签名只格式化一次日期，签名原文和 URL 参数使用同一个字符串，不会在秒边界上错开。
+// 服务端接受与其时钟相差 5 分钟以内的日期，签好的地址在 SIGNATURE_REUSE_SECS 内直接复用。
+class IatAuth
+{
+public:
+    static constexpr int SIGNATURE_REUSE_SECS = 60;
+
+    IatAuth() = default;
+    IatAuth(const IatCredentials &credentials, const QUrl &endpoint);
+
+    // 凭据或地址变化时丢弃缓存的签名
+    void setCredentials(const IatCredentials &credentials);
+    void setEndpoint(const QUrl &endpoint);
+    const IatCredentials &credentials() const { return m_credentials; }
+    const QUrl &endpoint() const { return m_endpoint; }
+
+    // 带 authorization/date/host 参数的连接地址
+    QUrl signedUrl(const QDateTime &nowUtc = QDateTime::currentDateTimeUtc());
+
+    // RFC 1123 格式，例如 "Sat, 17 Oct 2026 08:00:00 GMT"
+    static QString httpDate(const QDateTime &utc);
+
+private:
+    QByteArray authorization(const QString &date) const;
+
+    IatCredentials m_credentials;
+    QUrl m_endpoint;
+    QUrl m_cachedUrl;
+    QDateTime m_signedAt;
+};
+
+#endif // IATAUTH_H
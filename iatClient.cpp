@@ -0,0 +1,827 @@
+#include "iatClient.h"
+#include "iatConnectionPool.h"
+#include "pipelineMetrics.h"
+
+#include <QWebSocket>
+#include <QTimer>
+#include <QDebug>
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(lcIatMessages, "speech.iat.messages", QtWarningMsg)
+
+namespace {
+constexpr qint64 MAX_PENDING_SEND_BYTES = 1600 * BYTES_PER_MS * 4 / 3;  // 约1.6秒音频的 base64 数据，与帧长无关
+constexpr int FINAL_RESPONSE_TIMEOUT_MS = 1000;  // 结束帧发出后等待最终结果的最短时间
+constexpr int MAX_FINAL_RESPONSE_TIMEOUT_MS = 60000;  // 同上，最长时间，与服务端单次会话的音频上限相当
+constexpr int WARM_CONNECTIONS = 1;  // 预先建立的空闲连接数
+constexpr int MAX_REPLAY_MS = 25000;  // 重放窗口上限，更早的帧断线后不再补发
+constexpr int MAX_RECONNECT_ATTEMPTS = 5;
+constexpr int RECONNECT_BASE_DELAY_MS = 100;  // 第一次立即重连，之后 100、200、400ms... 递增
+constexpr int RTT_PROBE_INTERVAL_MS = 1000;  // 自适应帧长：往返时延探测间隔
+constexpr int ADAPT_INTERVAL_MS = 1000;      // 自适应帧长：两次调整之间的最短间隔
+constexpr int BACKLOG_GROW_MESSAGES = 2;     // 发送积压达到这么多条消息时帧长加倍
+}
+
+IatClient::IatClient(SpscQueue<EncodedFrame> *input, SpscQueue<QByteArray> *recycled, QObject *parent)
+    : PipelineStage(parent)
+    , m_input(input)
+    , m_recycled(recycled)
+    , m_endpoint(QString(IAT_ENDPOINT))
+{
+}
+
+void IatClient::initialize()
+{
+    if (m_pool) {
+        return;
+    }
+
+    // 在网络线程中创建，socket 的所有 I/O 都发生在本线程
+    m_pool = new IatConnectionPool(this);
+    m_pool->setPoolSize(WARM_CONNECTIONS);
+
+    m_pump = new FramePump(this);
+    m_pump->setMaxPendingBytes(MAX_PENDING_SEND_BYTES);
+    m_pump->setMaxFramesPerTurn(m_maxFramesPerTurn);
+    m_pump->setFrameSource(
+        [this]() { return m_state == Streaming && (m_replaySent < m_replay.size() || !m_input->isEmpty()); },
+        [this]() { return sendNextFrame(); });
+
+    m_closeTimer = new QTimer(this);
+    m_closeTimer->setSingleShot(true);
+    connect(m_closeTimer, &QTimer::timeout, this, [this]() {
+        // 没有最终结果，识别文本可能缺少结尾：作为错误上报，调用方不应把它当作完整结果
+        qDebug() << "No final result in time, closing WebSocket connection";
+        emit errorResponse(-1, QString("No final result within %1 ms").arg(m_closeTimer->interval()));
+        finishSession();
+    });
+
+    m_segmentTimer = new QTimer(this);
+    m_segmentTimer->setSingleShot(true);
+    connect(m_segmentTimer, &QTimer::timeout, this, [this]() {
+        qDebug() << "No final result for segment" << m_previousSegmentIndex << "in time";
+        finishPreviousSegment();
+    });
+
+    m_reconnectTimer = new QTimer(this);
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &IatClient::reconnect);
+
+    // 自适应帧长：发送期间定时用 ping/pong 测量往返时延
+    m_probeTimer = new QTimer(this);
+    m_probeTimer->setInterval(RTT_PROBE_INTERVAL_MS);
+    connect(m_probeTimer, &QTimer::timeout, this, [this]() {
+        if (m_webSocket && m_state == Streaming) {
+            m_webSocket->ping();
+        }
+    });
+}
+
+void IatClient::configurePool()
+{
+    initialize();
+    m_pool->setCredentials(m_credentials);
+    m_pool->setEndpoint(m_endpoint);
+}
+
+void IatClient::prewarm()
+{
+    configurePool();
+    m_pool->warmUp();
+}
+
+void IatClient::attachSocket(QWebSocket *socket)
+{
+    m_webSocket = socket;
+    m_webSocket->setParent(this);
+    m_pump->setSocket(m_webSocket);
+
+    // WebSocket 连接和错误处理；分段后旧连接仍会收到结果，按 socket 区分所属分段
+    connect(m_webSocket, &QWebSocket::connected, this, [this, socket]() { onConnected(socket); });
+    connect(m_webSocket, &QWebSocket::disconnected, this, [this, socket]() { onDisconnected(socket); });
+    connect(m_webSocket, &QWebSocket::textMessageReceived,
+            this, [this, socket](const QString &message) { onTextMessage(socket, message); });
+
+    connect(m_webSocket, &QWebSocket::errorOccurred,
+            this, [this, socket](QAbstractSocket::SocketError error) {
+                qDebug() << "WebSocket error:" << error << socket->errorString();
+                if (m_metrics) {
+                    m_metrics->add(PipelineMetrics::ConnectionErrors);
+                }
+                if (socket != m_webSocket) {
+                    return;
+                }
+                m_lastError = socket->errorString();
+                // 连接未建立时不会收到 disconnected，需在这里重连
+                if (m_state == Connecting) {
+                    recover();
+                }
+            });
+
+    connect(m_webSocket, &QWebSocket::pong,
+            this, [this, socket](quint64 elapsedTime, const QByteArray &) {
+                if (socket != m_webSocket) {
+                    return;
+                }
+                // 指数加权平均，单次抖动不会立即改变帧长
+                m_rttMs = m_rttMs < 0 ? double(elapsedTime) : m_rttMs * 0.75 + double(elapsedTime) * 0.25;
+            });
+
+    connect(m_webSocket, &QWebSocket::stateChanged,
+            this, [](QAbstractSocket::SocketState state) {
+                qDebug() << "WebSocket state changed:" << state;
+            });
+}
+
+void IatClient::releaseSocket()
+{
+    if (!m_webSocket) {
+        return;
+    }
+    m_pump->setSocket(nullptr);
+    discardSocket(m_webSocket);
+    m_webSocket = nullptr;
+}
+
+void IatClient::discardSocket(QWebSocket *socket)
+{
+    disconnect(socket, nullptr, this, nullptr);
+    socket->abort();
+    socket->deleteLater();
+}
+
+void IatClient::reset(FramePump::Pacing pacing)
+{
+    configurePool();
+
+    // 先置为空闲，旧连接断开时不再上报会话结束
+    m_state = Idle;
+    m_pump->stop();
+    m_closeTimer->stop();
+    m_segmentTimer->stop();
+    m_reconnectTimer->stop();
+    releaseSocket();
+    if (m_previousSocket) {
+        discardSocket(m_previousSocket);
+        m_previousSocket = nullptr;
+    }
+    m_heldResults.clear();
+    m_segmentIndex = 0;
+    m_segmentFrames = 0;
+    m_segmentOverlaps = false;
+    m_reheadNextFrame = false;
+    m_awaitingFirstFrame = false;
+    clearReplay();
+    m_reconnectAttempts = 0;
+    m_lastError.clear();
+
+    // 每次会话从设定的帧长开始，自适应模式再按链路状况调整
+    m_frameMs = m_baseFrameMs;
+    m_rttMs = -1;
+    m_lastMessageSize = 0;
+    m_adaptClock.start();
+    if (m_adaptive) {
+        m_probeTimer->start();
+    } else {
+        m_probeTimer->stop();
+    }
+
+    m_input->clear();
+    m_pump->setPacing(pacing);
+    m_sessionClock.start();
+    m_sessionStartNs = PipelineMetrics::now();
+    m_lastWriteNs = 0;
+    m_finalWriteNs = 0;
+    m_resultSeen = false;
+    if (m_metrics) {
+        m_metrics->add(PipelineMetrics::SessionsStarted);
+    }
+
+    if (m_listening) {
+        // 听音模式：第一句话的帧到达时才取连接
+        m_state = Waiting;
+        return;
+    }
+    attachSocket(m_pool->acquire());
+    if (m_webSocket->state() == QAbstractSocket::ConnectedState) {
+        startStreaming();
+    } else {
+        m_state = Connecting;
+    }
+}
+
+void IatClient::process()
+{
+    if (m_state == Streaming) {
+        m_pump->schedule();
+    } else if (m_state == Waiting && !m_input->isEmpty()) {
+        if (m_input->peek()->message.isEmpty()) {
+            EncodedFrame marker;
+            m_input->pop(marker);
+            finishBetweenSegments();
+            return;
+        }
+        qDebug() << "Speech queued, opening segment" << m_segmentIndex;
+        attachSocket(m_pool->acquire());
+        if (m_webSocket->state() == QAbstractSocket::ConnectedState) {
+            startStreaming();
+        } else {
+            m_state = Connecting;
+        }
+    }
+}
+
+void IatClient::onConnected(QWebSocket *socket)
+{
+    qDebug() << "WebSocket connected successfully";
+    if (socket == m_webSocket && m_state == Connecting) {
+        startStreaming();
+    }
+}
+
+void IatClient::startStreaming()
+{
+    qDebug() << "Streaming segment" << m_segmentIndex << "after" << m_sessionClock.elapsed()
+             << "ms, queued frames:" << m_input->size();
+    m_state = Streaming;
+    // 断线重连后由发送调度先补发窗口中的帧，之后的帧照常从队列发送
+    if (m_pump->isActive()) {
+        // 后续分段沿用音频流的节拍
+        m_pump->schedule();
+    } else {
+        // 握手期间积压的音频按实际时长计入节拍
+        m_pump->start(m_sessionClock.elapsed());
+    }
+}
+
+void IatClient::onDisconnected(QWebSocket *socket)
+{
+    if (socket == m_previousSocket) {
+        finishPreviousSegment();
+        return;
+    }
+    if (socket != m_webSocket) {
+        return;
+    }
+
+    if (m_state == Idle) {
+        return;
+    }
+    if (m_state != Closing) {
+        // 最终结果到达之前断开属于异常断开，换一条连接继续
+        m_lastError = socket->errorString();
+        recover();
+        return;
+    }
+
+    m_pump->stop();
+    m_closeTimer->stop();
+    m_probeTimer->stop();
+    // 上一段的结果先于本段发出
+    finishPreviousSegment();
+    m_state = Idle;
+    emit sessionClosed();
+}
+
+int IatClient::sendNextFrame()
+{
+    if (m_replaySent < m_replay.size()) {
+        return sendReplayFrame();
+    }
+
+    // 服务端提前结束了上一段且为压缩编码：新一段第一帧之前的帧无法接续，归还缓冲区后丢弃
+    while (m_awaitingFirstFrame) {
+        const EncodedFrame *next = m_input->peek();
+        if (!next) {
+            return 0;
+        }
+        if (next->first || next->message.isEmpty()) {
+            m_awaitingFirstFrame = false;
+            break;
+        }
+        EncodedFrame dropped;
+        m_input->pop(dropped);
+        m_recycled->push(std::move(dropped.message));
+        if (m_upstream) {
+            m_upstream->wake();
+        }
+        if (dropped.last) {
+            // 编码阶段重新开始之前音频流已经结束，新一段没有音频
+            m_awaitingFirstFrame = false;
+            finishBetweenSegments();
+            return 0;
+        }
+    }
+
+    const EncodedFrame *next = m_input->peek();
+    if (!next) {
+        return 0;
+    }
+    if (next->first && m_segmentFrames > 0) {
+        // 编码阶段已开始新一段而本段没有结束帧 (重新开始与正常切分同时发生)，同样换用新连接
+        beginSegment();
+        if (m_state != Streaming) {
+            return 0;
+        }
+    }
+
+    EncodedFrame frame;
+    m_input->pop(frame);
+    if (m_upstream) {
+        m_upstream->wake();
+    }
+    if (frame.message.isEmpty()) {
+        m_reheadNextFrame = false;
+        finishBetweenSegments();
+        return 0;
+    }
+
+    bool extraEndFrame = false;
+    if (m_reheadNextFrame) {
+        m_reheadNextFrame = false;
+        if (!frame.first) {
+            // 服务端提前结束了上一段：本帧改写为新一段的第一帧，音频不丢失也不重复发送
+            QByteArray original = std::move(frame.message);
+            frame.message = IatFrameWriter::rewriteFrame(original, STATUS_FIRST_FRAME, m_replayHeader);
+            m_recycled->push(std::move(original));
+            frame.first = true;
+            frame.overlap = false;
+            // 本帧原是结束帧：音频随第一帧发出，再补一个空的结束帧
+            extraEndFrame = frame.last || frame.segmentEnd;
+        }
+    }
+
+    sendMessage(frame.message);
+    if (extraEndFrame) {
+        sendMessage(IatFrameWriter::rewriteFrame(frame.message, STATUS_LAST_FRAME, m_replayHeader, false));
+    }
+    m_lastMessageSize = frame.message.size();
+    if (m_metrics) {
+        m_metrics->record(PipelineMetrics::EmitToWrite, frame.emittedAtNs, m_lastWriteNs);
+        m_metrics->record(PipelineMetrics::CaptureToWrite, frame.capturedAtNs, m_lastWriteNs);
+    }
+
+    if (frame.first) {
+        m_segmentOverlaps = frame.overlap;
+        m_replayHeader = IatFrameWriter::frameHeader(frame.message).toByteArray();
+    }
+    ++m_segmentFrames;
+
+    if (m_encoding == AudioEncoding::Raw) {
+        // 留在重放窗口中，直到被稳定结果覆盖；超出上限时最旧的帧归还编码阶段
+        ReplayFrame sent;
+        sent.message = std::move(frame.message);
+        sent.beginMs = m_segmentAudioMs;
+        sent.audioMs = frame.audioMs;
+        sent.last = frame.last;
+        m_replay.append(std::move(sent));
+        ++m_replaySent;
+    } else {
+        // 压缩编码不重放，发出后立即归还
+        m_recycled->push(std::move(frame.message));
+    }
+    m_segmentAudioMs += frame.audioMs;
+    while (m_replay.size() > 1 && m_replay.first().beginMs + MAX_REPLAY_MS < m_segmentAudioMs) {
+        m_recycled->push(m_replay.takeFirst().message);
+        --m_replaySent;
+    }
+
+    if (frame.last) {
+        qDebug() << "Sent final end frame";
+        m_finalWriteNs = m_lastWriteNs;
+        m_state = Finishing;
+        m_pump->stop();
+        m_closeTimer->start(finalResponseTimeout());
+    } else if (frame.segmentEnd) {
+        qDebug() << "Sent end frame of segment" << m_segmentIndex << "after" << m_segmentFrames << "frames";
+        beginSegment();
+    } else if (m_adaptive) {
+        adaptFrameDuration();
+    }
+    return frame.audioMs;
+}
+
+void IatClient::setFrameDuration(int msecs, bool adaptive)
+{
+    m_baseFrameMs = boundFrameMs(msecs);
+    m_adaptive = adaptive;
+}
+
+void IatClient::adaptFrameDuration()
+{
+    if (!m_webSocket || m_adaptClock.elapsed() < ADAPT_INTERVAL_MS) {
+        return;
+    }
+    m_adaptClock.restart();
+
+    // 往返时延高时结果本来就回来得晚，帧长取时延的一半即可，不必为更小的帧多付消息开销
+    int target = m_rttMs < 0 ? MIN_FRAME_MS : boundFrameMs(int(m_rttMs / 2));
+    // 发送积压说明链路跟不上：把帧合并得更大，减少消息条数和 JSON/base64 的固定开销
+    const qint64 backlog = m_lastMessageSize > 0 ? m_webSocket->bytesToWrite() / m_lastMessageSize : 0;
+    if (backlog >= BACKLOG_GROW_MESSAGES) {
+        target = qMax(target, m_frameMs * 2);
+    } else if (backlog > 0) {
+        target = qMax(target, m_frameMs);
+    } else {
+        target = qMax(target, m_frameMs / 2);  // 每次最多缩小一半，避免来回跳动
+    }
+    target = boundFrameMs(target);
+    if (target == m_frameMs) {
+        return;
+    }
+
+    qDebug() << "Adapting frame duration to" << target << "ms, rtt:" << m_rttMs << "ms, backlog:" << backlog;
+    m_frameMs = target;
+    emit frameDurationChanged(target);
+}
+
+void IatClient::sendMessage(const QByteArray &message)
+{
+    // 消息只含 ASCII 字符，直接逐字节扩展到复用的 QString 中，省去 UTF-8 解码和一次分配；
+    // QWebSocket 的文本接口内部仍会再转换一次 UTF-8
+    const qsizetype size = message.size();
+    m_sendBuffer.resize(size);
+    char16_t *dst = reinterpret_cast<char16_t *>(m_sendBuffer.data());
+    const char *src = message.constData();
+    for (qsizetype i = 0; i < size; ++i) {
+        dst[i] = uchar(src[i]);
+    }
+    m_webSocket->sendTextMessage(m_sendBuffer);
+
+    m_lastWriteNs = PipelineMetrics::now();
+    if (m_metrics) {
+        m_metrics->add(PipelineMetrics::FramesSent);
+        m_metrics->add(PipelineMetrics::BytesUploaded, quint64(size));
+    }
+}
+
+void IatClient::beginSegment()
+{
+    // 再上一段仍未结束时不再等待其结果
+    finishPreviousSegment();
+
+    // 当前连接留下等待本段的最终结果，下一段换用连接池中预先握手的连接
+    m_previousSocket = m_webSocket;
+    m_previousSegmentIndex = m_segmentIndex;
+    m_webSocket = nullptr;
+    m_segmentTimer->start(finalResponseTimeout());
+
+    // 上一段的帧不再重放：其连接断开时只放弃尚未到达的结果
+    clearReplay();
+    ++m_segmentIndex;
+    m_segmentFrames = 0;
+    m_segmentOverlaps = false;
+
+    if (m_listening && m_input->isEmpty()) {
+        // 听音模式下一句话说完：两句之间不占用连接，下一句的帧到达时由 process() 再取
+        qDebug() << "Waiting for speech before segment" << m_segmentIndex;
+        m_state = Waiting;
+        return;
+    }
+    attachSocket(m_pool->acquire());
+    if (m_webSocket->state() == QAbstractSocket::ConnectedState) {
+        qDebug() << "Segment" << m_segmentIndex << "continues on a warm connection";
+        m_state = Streaming;
+    } else {
+        // 连接完成后由 onConnected() 继续发送
+        m_state = Connecting;
+    }
+}
+
+void IatClient::finishPreviousSegment()
+{
+    if (!m_previousSocket) {
+        return;
+    }
+    m_segmentTimer->stop();
+    discardSocket(m_previousSocket);
+    m_previousSocket = nullptr;
+
+    // 上一段的结果已全部发出，放行本段暂存的结果
+    for (const RecognitionResult &result : std::as_const(m_heldResults)) {
+        emit resultReceived(result);
+    }
+    m_heldResults.clear();
+}
+
+void IatClient::finishBetweenSegments()
+{
+    // 上一段结束后音频流随即结束，没有新的一段要发送
+    qDebug() << "Audio stream ended before segment" << m_segmentIndex << "had any audio";
+    m_pump->stop();
+    releaseSocket();
+    m_finalWriteNs = PipelineMetrics::now();
+    if (m_previousSocket) {
+        // 上一段就是最后一段：改为等待它的最终结果来结束整个会话，等待时间沿用该段剩余的部分
+        const int remaining = m_segmentTimer->remainingTime();
+        m_segmentTimer->stop();
+        m_webSocket = m_previousSocket;
+        m_previousSocket = nullptr;
+        m_segmentIndex = m_previousSegmentIndex;
+        m_state = Finishing;
+        m_closeTimer->start(qMax(FINAL_RESPONSE_TIMEOUT_MS, remaining));
+        return;
+    }
+
+    // 上一段的结果都已收到
+    if (m_metrics) {
+        m_metrics->add(PipelineMetrics::SessionsCompleted);
+    }
+    emit finalResultReceived();
+    finishSession();
+}
+
+int IatClient::finalResponseTimeout() const
+{
+    // 服务端至少按实时速度识别：本段尚未得到稳定结果的音频越多，最终结果来得越晚。
+    // 文件按最大吞吐量发送时，结束帧发出时服务端往往还有几十秒音频没有识别
+    const qint64 pendingMs = qMax<qint64>(0, m_segmentAudioMs - m_acknowledgedMs);
+    return int(qMin<qint64>(FINAL_RESPONSE_TIMEOUT_MS + pendingMs, MAX_FINAL_RESPONSE_TIMEOUT_MS));
+}
+
+void IatClient::finishSession()
+{
+    m_pump->stop();
+    m_closeTimer->stop();
+    m_reconnectTimer->stop();
+    if (m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState) {
+        m_state = Closing;
+        m_webSocket->close();
+        return;
+    }
+    // 没有可关闭的连接，直接结束
+    m_state = Idle;
+    releaseSocket();
+    finishPreviousSegment();
+    emit sessionClosed();
+}
+
+void IatClient::deliverResult(const RecognitionResult &result)
+{
+    if (m_previousSocket) {
+        m_heldResults.append(result);
+    } else {
+        emit resultReceived(result);
+    }
+}
+
+void IatClient::recover()
+{
+    m_pump->stop();
+    m_closeTimer->stop();
+    releaseSocket();
+
+    if (m_reconnectAttempts >= MAX_RECONNECT_ATTEMPTS) {
+        qDebug() << "Giving up after" << m_reconnectAttempts << "reconnect attempts";
+        m_state = Idle;
+        finishPreviousSegment();
+        emit errorResponse(-1, m_lastError.isEmpty() ? QString("Connection lost") : m_lastError);
+        emit sessionClosed();
+        return;
+    }
+
+    if (m_encoding != AudioEncoding::Raw) {
+        if (m_finalWriteNs != 0) {
+            // 结束帧已发出，压缩编码又没有可重放的音频：新连接上无事可做
+            qDebug() << "Connection lost after the final frame, compressed audio cannot be replayed";
+            m_state = Idle;
+            finishPreviousSegment();
+            emit errorResponse(-1, m_lastError.isEmpty() ? QString("Connection lost") : m_lastError);
+            emit sessionClosed();
+            return;
+        }
+        if (m_segmentFrames > 0 && !m_awaitingFirstFrame) {
+            // 已排队的帧接在旧连接的编码状态之后，丢弃它们，编码阶段从下一帧重新开始
+            m_awaitingFirstFrame = true;
+            emit segmentRestartRequested();
+        }
+    }
+
+    // 撤回旧连接上仍可能被修正的结果，对应的音频会在新会话中重新识别；没有可重放的音频时保留这些结果
+    if (!m_replay.isEmpty() && m_firstUnstableSn > 0 && m_lastSn >= m_firstUnstableSn) {
+        const int snOffset = m_segmentIndex * SEGMENT_SN_STRIDE;
+        RecognitionResult retraction;
+        retraction.sn = snOffset + m_lastSn;
+        retraction.replace = true;
+        retraction.replaceFirst = snOffset + m_firstUnstableSn;
+        retraction.replaceLast = snOffset + m_lastSn;
+        deliverResult(retraction);
+    }
+
+    if (m_reconnectAttempts == 0) {
+        m_connectionLostNs = PipelineMetrics::now();
+    }
+    const int delay = m_reconnectAttempts == 0 ? 0 : RECONNECT_BASE_DELAY_MS << (m_reconnectAttempts - 1);
+    ++m_reconnectAttempts;
+    qDebug() << "Connection lost in segment" << m_segmentIndex << "reconnecting in" << delay << "ms,"
+             << m_replay.size() << "frames to replay";
+    m_state = Reconnecting;
+    m_reconnectTimer->start(delay);
+}
+
+void IatClient::reconnect()
+{
+    if (m_state != Reconnecting) {
+        return;
+    }
+
+    // 重放的音频作为新的一段，结果序号与旧连接上的错开；
+    // 第一帧可能含有已稳定的词尾，按分段重叠去掉重复的文字
+    ++m_segmentIndex;
+    m_segmentFrames = 0;
+    m_segmentOverlaps = !m_replay.isEmpty();
+    if (!m_replay.isEmpty()) {
+        // 新会话的音频从窗口第一帧开始，时间偏移随之平移
+        const qint64 baseMs = m_replay.first().beginMs;
+        for (ReplayFrame &frame : m_replay) {
+            frame.beginMs -= baseMs;
+        }
+        m_segmentAudioMs -= baseMs;
+    }
+    m_acknowledgedMs = 0;
+    m_replaySent = 0;
+    m_firstUnstableSn = 0;
+    m_lastSn = 0;
+    if (m_metrics) {
+        m_metrics->add(PipelineMetrics::Reconnects);
+    }
+
+    // 连接池中通常有一条已握手的备用连接，可以立即接着发送
+    attachSocket(m_pool->acquire());
+    if (m_webSocket->state() == QAbstractSocket::ConnectedState) {
+        startStreaming();
+    } else {
+        m_state = Connecting;
+    }
+}
+
+int IatClient::sendReplayFrame()
+{
+    // 重放期间已确认的帧会移出窗口，新会话的第一帧按本段已发出的帧数判断
+    const bool first = m_segmentFrames == 0;
+    const ReplayFrame &frame = m_replay[m_replaySent++];
+    const FrameStatus status = first ? STATUS_FIRST_FRAME
+                                     : (frame.last ? STATUS_LAST_FRAME : STATUS_CONTINUE_FRAME);
+    sendMessage(IatFrameWriter::rewriteFrame(frame.message, status, m_replayHeader));
+    if (first && frame.last) {
+        // 唯一的一帧同时是结束帧：音频随第一帧发出，再补一个空的结束帧
+        sendMessage(IatFrameWriter::rewriteFrame(frame.message, STATUS_LAST_FRAME, m_replayHeader, false));
+    }
+    ++m_segmentFrames;
+    if (m_metrics) {
+        m_metrics->add(PipelineMetrics::FramesReplayed);
+    }
+
+    if (m_replaySent == m_replay.size()) {
+        const qint64 now = PipelineMetrics::now();
+        qDebug() << "Replayed" << m_replay.size() << "frames (" << m_segmentAudioMs << "ms ) after"
+                 << (now - m_connectionLostNs) / 1000000 << "ms";
+        if (m_metrics) {
+            m_metrics->record(PipelineMetrics::ReconnectTime, m_connectionLostNs, now);
+        }
+    }
+
+    if (frame.last) {
+        m_finalWriteNs = m_lastWriteNs;
+        m_state = Finishing;
+        m_pump->stop();
+        m_closeTimer->start(finalResponseTimeout());
+    }
+    return frame.audioMs;
+}
+
+void IatClient::acknowledge(qint64 audioMs)
+{
+    // 完全位于 audioMs 之前的帧已有稳定结果，断线后无需重放；尚未重放的帧不会有结果
+    while (m_replaySent > 0 && m_replay.first().beginMs + m_replay.first().audioMs <= audioMs
+           && !m_replay.first().last) {
+        m_recycled->push(m_replay.takeFirst().message);
+        --m_replaySent;
+    }
+}
+
+void IatClient::clearReplay()
+{
+    // 队列已满时直接丢弃，由编码阶段重新分配
+    for (ReplayFrame &frame : m_replay) {
+        m_recycled->push(std::move(frame.message));
+    }
+    m_replay.clear();
+    m_replaySent = 0;
+    m_segmentAudioMs = 0;
+    m_acknowledgedMs = 0;
+    m_firstUnstableSn = 0;
+    m_lastSn = 0;
+}
+
+void IatClient::onTextMessage(QWebSocket *socket, const QString &message)
+{
+    const bool previous = socket == m_previousSocket;
+    if (!previous && socket != m_webSocket) {
+        return;
+    }
+
+    // 完整消息只在开启 speech.iat.messages 分类时才格式化输出
+    qCDebug(lcIatMessages) << "Received WebSocket message:" << message;
+
+    if (!m_parser.parse(message, m_response)) {
+        qDebug() << "JSON parse error:" << m_parser.errorString();
+        return;
+    }
+
+    const qint64 receivedAt = PipelineMetrics::now();
+    const int code = m_response.code;
+    if (m_metrics) {
+        m_metrics->add(code != 0 ? PipelineMetrics::ServerErrors : PipelineMetrics::ResultsReceived);
+    }
+    if (code != 0) {
+        qDebug() << "Error response, code:" << code
+                 << "message:" << m_response.message;
+        emit errorResponse(code, m_response.message);
+        if (previous) {
+            finishPreviousSegment();
+        } else {
+            finishSession();
+        }
+        return;
+    }
+
+    // 解析识别结果
+    if (m_response.hasResult) {
+        if (m_metrics) {
+            m_metrics->record(PipelineMetrics::WriteToResult, m_lastWriteNs, receivedAt);
+            if (!m_resultSeen) {
+                m_metrics->record(PipelineMetrics::FirstResult, m_sessionStartNs, receivedAt);
+            }
+        }
+        m_resultSeen = true;
+
+        RecognitionResult &recognized = m_response.result;
+        if (!previous) {
+            // 新的 apd 结果之前的结果不会再被修正，其第一个词之前的音频不必重放
+            if (!recognized.replace) {
+                m_firstUnstableSn = recognized.sn;
+                if (recognized.beginMs >= 0) {
+                    acknowledge(recognized.beginMs);
+                    m_acknowledgedMs = qMax(m_acknowledgedMs, qint64(recognized.beginMs));
+                }
+            }
+            m_lastSn = recognized.sn;
+            m_reconnectAttempts = 0;
+        }
+
+        // 序号按所属分段错开，各段的替换范围互不重叠
+        const int snOffset = (previous ? m_previousSegmentIndex : m_segmentIndex) * SEGMENT_SN_STRIDE;
+        recognized.sn += snOffset;
+        if (recognized.replace) {
+            recognized.replaceFirst += snOffset;
+            recognized.replaceLast += snOffset;
+        }
+        recognized.overlapsPrevious = !previous && m_segmentOverlaps;
+
+        qCDebug(lcIatMessages) << "Recognized text:" << recognized.text << "sn:" << recognized.sn
+                               << (recognized.replace ? "replaces" : "appends")
+                               << recognized.replaceFirst << recognized.replaceLast;
+        if (previous) {
+            emit resultReceived(recognized);
+        } else {
+            deliverResult(recognized);
+        }
+    }
+
+    if (m_response.status != 2) {
+        return;
+    }
+
+    if (previous) {
+        qDebug() << "Received final response of segment" << m_previousSegmentIndex;
+        finishPreviousSegment();
+        return;
+    }
+
+    if (m_state == Connecting || m_state == Streaming) {
+        // 音频流尚未结束服务端就结束了本段 (如 vad_eos 超时)：换用新连接继续
+        qDebug() << "Service ended segment" << m_segmentIndex << "early, starting a new segment";
+        beginSegment();
+        finishPreviousSegment();
+        if (m_encoding == AudioEncoding::Raw) {
+            // 已经排队的帧接着发往新一段，第一帧在发送时改写
+            m_reheadNextFrame = true;
+        } else {
+            // 压缩编码的帧不能作为新会话的开头：编码阶段从下一帧重新开始，已排队的帧被丢弃
+            m_awaitingFirstFrame = true;
+            emit segmentRestartRequested();
+        }
+        return;
+    }
+
+    // 最后一段的最终结果：上一段暂存的结果先发出，再结束整个会话
+    qDebug() << "Received final response";
+    finishPreviousSegment();
+    if (m_metrics) {
+        m_metrics->record(PipelineMetrics::FinalResult, m_finalWriteNs, receivedAt);
+        m_metrics->add(PipelineMetrics::SessionsCompleted);
+    }
+    emit finalResultReceived();
+    finishSession();
+}
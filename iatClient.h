@@ -0,0 +1,188 @@
+#ifndef IATCLIENT_H
+#define IATCLIENT_H
+
+#include "pipelineStage.h"
+#include "spscQueue.h"
+#include "iatProtocol.h"
+#include "framePump.h"
+#include "iatCredentials.h"
+#include "iatResultParser.h"
+#include "iatFrameWriter.h"
+#include "audioCodec.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QUrl>
+
+class QWebSocket;
+class QTimer;
+class IatConnectionPool;
+
+// 网络阶段：在独立线程中维护与讯飞听写服务的 WebSocket 连接，
+// 发送编码好的帧并解析识别结果，结果通过信号排队投递给界面线程
+// 长音频分段时，上一段的结束帧发出后立即换用连接池中已握手的连接发送下一段，
+// 旧连接留下等待本段的最终结果；新一段的结果暂存到旧连接结束后再发出，保证顺序。
+// 各段结果序号按 SEGMENT_SN_STRIDE 错开，只有最后一段的最终结果才结束整个会话。
+// 服务端提前结束本段 (vad_eos) 时，已排队的帧接着发往新一段，其中第一帧改写为带参数的第一帧；
+// 压缩编码的帧依赖之前的编码器状态，无法这样接续，改为丢弃已排队的帧并由编码阶段重新开始。
+// 已发送但尚未被稳定结果覆盖的帧保留在有限的重放窗口中；连接意外断开时按退避间隔重连，
+// 撤回旧连接上仍可能被修正的结果，把窗口中的帧重放到新会话，期间采集和编码照常进行；
+// 重放的帧与实时的帧一样经由 FramePump 发送，受相同的节拍和发送积压限制。
+// 压缩编码时不保留重放窗口 (帧依赖之前的编码器状态，不能作为新会话的开头)：重连后编码阶段
+// 从下一帧重新开始一段干净的会话，断开时尚未识别的音频和已排队的帧不再补发，已有结果保留。
+// 听音模式下每句话是一段，两句之间不持有连接，下一句的第一帧到达时才从连接池取连接。
+class IatClient : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    // 发送完成的消息缓冲区归还到 recycled 队列，供编码阶段复用
+    IatClient(SpscQueue<EncodedFrame> *input, SpscQueue<QByteArray> *recycled, QObject *parent = nullptr);
+
+    void setUpstream(PipelineStage *stage) { m_upstream = stage; }
+    // 与其他会话共用网络线程时限制每次连续发送的帧数，移入工作线程之前调用
+    void setMaxFramesPerTurn(int frames) { m_maxFramesPerTurn = frames; }
+
+    // 在本阶段线程中调用，下次建立连接时生效
+    void setCredentials(const IatCredentials &credentials) { m_credentials = credentials; }
+    // 服务地址，默认 IAT_ENDPOINT；测试时可指向本地模拟服务
+    void setEndpoint(const QUrl &endpoint) { m_endpoint = endpoint; }
+    // 听音模式：会话开始时不取连接，每段 (一句话) 的第一帧到达时才取，段结束后立即释放。
+    // 在本阶段线程中调用，下次 reset() 时生效
+    void setListening(bool listening) { m_listening = listening; }
+    // 会话开始时的帧长；adaptive 为 true 时按往返时延和发送积压调整，
+    // 通过 frameDurationChanged 通知预处理阶段。在本阶段线程中调用，下次 reset() 时生效
+    void setFrameDuration(int msecs, bool adaptive);
+    // 编码阶段实际使用的上行编码，决定已编码的帧能否改写到新会话中发送。在本阶段线程中调用
+    void setAudioEncoding(AudioEncoding encoding) { m_encoding = encoding; }
+
+public slots:
+    // 开始新会话：断开旧连接、清空输入队列并设置发送节拍，
+    // 随即从连接池取出连接，握手已完成时首帧数据一到就发送
+    void reset(FramePump::Pacing pacing);
+    // 按当前凭据和地址预先建立连接
+    void prewarm();
+
+signals:
+    // 每条识别结果，含 wpgs 动态修正信息
+    void resultReceived(const RecognitionResult &result);
+    void finalResultReceived();
+    void errorResponse(int code, const QString &message);
+    void sessionClosed();
+    // 压缩编码时服务端提前结束了当前会话 (如 vad_eos) 或连接断开，编码阶段需从第一帧重新开始
+    void segmentRestartRequested();
+    // 自适应模式下建议的新帧长 (毫秒)
+    void frameDurationChanged(int msecs);
+
+protected:
+    void process() override;
+
+private:
+    enum State {
+        Idle,
+        Connecting,      // 连接仍在握手，期间到达的帧排队等待
+        Streaming,
+        Finishing,       // 结束帧已发出，等待最终结果
+        Reconnecting,    // 连接意外断开，等待退避后重连
+        Waiting,         // 听音模式下两句之间，不占用连接
+        Closing          // 本端主动关闭，断开后结束会话
+    };
+
+    // 重放窗口中的一帧，beginMs 为其音频在当前会话中的起始时间
+    struct ReplayFrame
+    {
+        QByteArray message;
+        qint64 beginMs = 0;
+        int audioMs = 0;
+        bool last = false;
+    };
+
+    void initialize();
+    void configurePool();
+    void attachSocket(QWebSocket *socket);
+    void releaseSocket();
+    void discardSocket(QWebSocket *socket);
+    void startStreaming();
+    int sendNextFrame();  // 返回发出的音频时长 (毫秒)，没有发出时为 0
+    int sendReplayFrame();  // 补发重放窗口中的下一帧
+    void sendMessage(const QByteArray &message);
+    // 结束帧发出后等待最终结果的时间，随本段尚未得到稳定结果的音频时长增加
+    int finalResponseTimeout() const;
+    void finishSession();
+    void finishBetweenSegments();
+    void deliverResult(const RecognitionResult &result);
+    void beginSegment();
+    void finishPreviousSegment();
+
+    void recover();
+    void reconnect();
+    void acknowledge(qint64 audioMs);
+    void clearReplay();
+    void adaptFrameDuration();
+
+    void onConnected(QWebSocket *socket);
+    void onDisconnected(QWebSocket *socket);
+    void onTextMessage(QWebSocket *socket, const QString &message);
+
+    SpscQueue<EncodedFrame> *m_input;
+    SpscQueue<QByteArray> *m_recycled;
+    PipelineStage *m_upstream = nullptr;
+    IatCredentials m_credentials;
+    QUrl m_endpoint;
+    QString m_sendBuffer;  // 复用的文本帧缓冲区
+    IatResultParser m_parser;
+    IatResponse m_response;  // 复用的解析结果
+
+    IatConnectionPool *m_pool = nullptr;
+    QWebSocket *m_webSocket = nullptr;  // 当前会话的连接
+    FramePump *m_pump = nullptr;
+    int m_maxFramesPerTurn = 0;
+    QTimer *m_closeTimer = nullptr;
+    bool m_listening = false;
+    AudioEncoding m_encoding = AudioEncoding::Raw;
+
+    // 帧长设置与自适应
+    int m_baseFrameMs = DEFAULT_FRAME_MS;
+    bool m_adaptive = false;
+    int m_frameMs = DEFAULT_FRAME_MS;  // 当前建议的帧长
+    double m_rttMs = -1;               // 往返时延的加权平均，尚未测得时为 -1
+    qint64 m_lastMessageSize = 0;      // 最近一条消息的大小，用于把发送积压换算成消息条数
+    QTimer *m_probeTimer = nullptr;
+    QElapsedTimer m_adaptClock;        // 距上次调整的时间
+
+    // 长音频分段
+    QWebSocket *m_previousSocket = nullptr;  // 上一段的连接，等待其最终结果
+    QTimer *m_segmentTimer = nullptr;        // 上一段等待最终结果的超时
+    QList<RecognitionResult> m_heldResults;  // 上一段结束之前收到的本段结果
+    int m_segmentIndex = 0;
+    int m_previousSegmentIndex = 0;
+    int m_segmentFrames = 0;                 // 本段已发送的帧数
+    bool m_segmentOverlaps = false;          // 本段的第一帧重复了上一段末尾的音频
+    bool m_reheadNextFrame = false;          // 服务端提前结束本段，下一帧改写为新一段的第一帧
+    bool m_awaitingFirstFrame = false;       // 同上但为压缩编码，丢弃编码阶段重新开始之前的帧
+
+    // 断线重连与重放
+    QList<ReplayFrame> m_replay;   // 当前会话中尚未被稳定结果覆盖的帧，最旧的在前
+    int m_replaySent = 0;          // m_replay 中已在当前连接上发出的帧数，其后的帧等待重放
+    QByteArray m_replayHeader;     // 第一帧中 data 之前的 common/business 部分
+    qint64 m_segmentAudioMs = 0;   // 当前会话已发送的音频时长
+    qint64 m_acknowledgedMs = 0;   // 当前会话中已有稳定结果的音频时长
+    int m_firstUnstableSn = 0;     // 当前会话中最新的 apd 结果序号，此后的结果仍可能被修正
+    int m_lastSn = 0;
+    QTimer *m_reconnectTimer = nullptr;
+    int m_reconnectAttempts = 0;
+    qint64 m_connectionLostNs = 0;
+    QString m_lastError;
+
+    State m_state = Idle;
+    QElapsedTimer m_sessionClock;  // 本次音频流开始的时间
+
+    // 指标时间戳 (PipelineMetrics::now())
+    qint64 m_sessionStartNs = 0;
+    qint64 m_lastWriteNs = 0;
+    qint64 m_finalWriteNs = 0;
+    bool m_resultSeen = false;
+};
+
+#endif // IATCLIENT_H
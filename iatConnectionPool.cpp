@@ -0,0 +1,188 @@
+#include "iatConnectionPool.h"
+#include "iatProtocol.h"
+
+#include <QTimer>
+#include <QWebSocket>
+#include <QDebug>
+
+namespace {
+// 服务端约 10 秒收不到音频就会断开连接，空闲连接在此之前轮换
+constexpr int DEFAULT_MAX_IDLE_MS = 8000;
+constexpr int ROTATE_CHECK_MS = 1000;
+constexpr int RETRY_DELAY_MS = 2000;
+constexpr int MAX_WARM_FAILURES = 3;
+}
+
+IatConnectionPool::IatConnectionPool(QObject *parent)
+    : QObject(parent)
+    , m_auth(IatCredentials(), QUrl(QString(IAT_ENDPOINT)))
+    , m_rotateTimer(new QTimer(this))
+    , m_retryTimer(new QTimer(this))
+    , m_maxIdleMs(DEFAULT_MAX_IDLE_MS)
+{
+    m_rotateTimer->setInterval(ROTATE_CHECK_MS);
+    connect(m_rotateTimer, &QTimer::timeout, this, &IatConnectionPool::rotate);
+
+    m_retryTimer->setSingleShot(true);
+    m_retryTimer->setInterval(RETRY_DELAY_MS);
+    connect(m_retryTimer, &QTimer::timeout, this, &IatConnectionPool::warmUp);
+}
+
+IatConnectionPool::~IatConnectionPool()
+{
+    clear();
+}
+
+void IatConnectionPool::setCredentials(const IatCredentials &credentials)
+{
+    if (credentials != m_auth.credentials()) {
+        m_auth.setCredentials(credentials);
+        clear();
+    }
+}
+
+void IatConnectionPool::setEndpoint(const QUrl &endpoint)
+{
+    if (endpoint != m_auth.endpoint()) {
+        m_auth.setEndpoint(endpoint);
+        clear();
+    }
+}
+
+void IatConnectionPool::setPoolSize(int size)
+{
+    m_poolSize = qMax(0, size);
+    while (m_idle.size() > m_poolSize) {
+        retire(m_idle.last().socket);
+    }
+}
+
+QWebSocket *IatConnectionPool::acquire()
+{
+    m_failures = 0;
+
+    QWebSocket *socket = nullptr;
+    for (const Entry &entry : std::as_const(m_idle)) {
+        if (entry.socket->state() == QAbstractSocket::ConnectedState) {
+            socket = entry.socket;
+            break;
+        }
+    }
+    if (!socket && !m_idle.isEmpty()) {
+        socket = m_idle.first().socket;
+    }
+
+    if (socket) {
+        qDebug() << "Using pre-warmed connection, state:" << socket->state();
+        untrack(socket);
+    } else {
+        socket = openSocket();
+    }
+    socket->setParent(nullptr);
+
+    // 取走之后立即补上，供下一次会话使用
+    QTimer::singleShot(0, this, &IatConnectionPool::warmUp);
+    return socket;
+}
+
+void IatConnectionPool::warmUp()
+{
+    if (!m_auth.credentials().isComplete() || m_failures >= MAX_WARM_FAILURES) {
+        return;
+    }
+    while (m_idle.size() < m_poolSize) {
+        track(openSocket());
+    }
+}
+
+void IatConnectionPool::clear()
+{
+    m_retryTimer->stop();
+    while (!m_idle.isEmpty()) {
+        retire(m_idle.last().socket);
+    }
+}
+
+QWebSocket *IatConnectionPool::openSocket()
+{
+    QWebSocket *socket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+    const QUrl url = m_auth.signedUrl();
+    qDebug() << "Opening WebSocket connection to" << url.host() << url.path();
+    socket->open(url);
+    return socket;
+}
+
+void IatConnectionPool::track(QWebSocket *socket)
+{
+    Entry entry;
+    entry.socket = socket;
+    entry.age.start();
+    m_idle.append(entry);
+
+    connect(socket, &QWebSocket::connected, this, [this]() { m_failures = 0; });
+    connect(socket, &QWebSocket::disconnected, this, [this, socket]() { onSocketLost(socket); });
+    connect(socket, &QWebSocket::errorOccurred, this, [this, socket]() { onSocketLost(socket); });
+
+    if (!m_rotateTimer->isActive()) {
+        m_rotateTimer->start();
+    }
+}
+
+void IatConnectionPool::untrack(QWebSocket *socket)
+{
+    disconnect(socket, nullptr, this, nullptr);
+    for (qsizetype i = 0; i < m_idle.size(); ++i) {
+        if (m_idle[i].socket == socket) {
+            m_idle.removeAt(i);
+            break;
+        }
+    }
+    if (m_idle.isEmpty()) {
+        m_rotateTimer->stop();
+    }
+}
+
+void IatConnectionPool::retire(QWebSocket *socket)
+{
+    untrack(socket);
+    if (socket->state() == QAbstractSocket::ConnectedState) {
+        // 正常关闭，服务端收到 close 帧后释放会话资源
+        connect(socket, &QWebSocket::disconnected, socket, &QObject::deleteLater);
+        socket->close();
+    } else {
+        socket->abort();
+        socket->deleteLater();
+    }
+}
+
+void IatConnectionPool::onSocketLost(QWebSocket *socket)
+{
+    qDebug() << "Pre-warmed connection lost:" << socket->errorString();
+    ++m_failures;  // 握手成功时清零
+    retire(socket);
+
+    // 连续失败时 (例如凭据错误、网络不通) 放慢重试，达到上限后停止
+    if (m_failures < MAX_WARM_FAILURES) {
+        m_retryTimer->start();
+    }
+}
+
+void IatConnectionPool::rotate()
+{
+    QList<QWebSocket *> expired;
+    for (const Entry &entry : std::as_const(m_idle)) {
+        if (entry.age.elapsed() >= m_maxIdleMs) {
+            expired.append(entry.socket);
+        }
+    }
+    if (expired.isEmpty()) {
+        return;
+    }
+
+    // 先建新连接再关闭旧连接，轮换期间始终有可用连接
+    for (QWebSocket *socket : std::as_const(expired)) {
+        untrack(socket);
+        track(openSocket());
+        retire(socket);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef IATCONNECTIONPOOL_H
+#define IATCONNECTIONPOOL_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+
+#include "iatAuth.h"
+
+class QTimer;
+class QWebSocket;
+
+// 预先建立好的听写服务连接
+// 始终保持 poolSize 条已完成 TLS 和 WebSocket 握手的空闲连接，开始识别时直接取用，
+// 首帧无需再等待握手。空闲连接存活超过 maxIdleMs 后先建新连接再关闭旧连接，
+// 避免被服务端以空闲超时断开或签名日期过期。
+// 只能在所属线程中使用。
+class IatConnectionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IatConnectionPool(QObject *parent = nullptr);
+    ~IatConnectionPool() override;
+
+    // 凭据或地址变化时关闭已有的空闲连接
+    void setCredentials(const IatCredentials &credentials);
+    void setEndpoint(const QUrl &endpoint);
+
+    // 0 表示不预建连接，每次 acquire() 都新建
+    void setPoolSize(int size);
+    void setMaxIdleMs(int msecs) { m_maxIdleMs = msecs; }
+
+    // 取出一条连接，调用方接管所有权 (包括 parent)；
+    // 优先返回已连接的，其次是正在握手的，都没有时新建。之后在后台补足空闲连接。
+    QWebSocket *acquire();
+
+    // 补足空闲连接，凭据不完整时不预建
+    void warmUp();
+    void clear();
+
+private:
+    struct Entry
+    {
+        QWebSocket *socket = nullptr;
+        QElapsedTimer age;
+    };
+
+    QWebSocket *openSocket();
+    void track(QWebSocket *socket);
+    void untrack(QWebSocket *socket);
+    void retire(QWebSocket *socket);
+    void onSocketLost(QWebSocket *socket);
+    void rotate();
+
+    IatAuth m_auth;
+    QList<Entry> m_idle;
+    QTimer *m_rotateTimer;
+    QTimer *m_retryTimer;
+    int m_poolSize = 1;
+    int m_maxIdleMs;
+    int m_failures = 0;  // 连续握手失败次数，达到上限后停止预建，直到下次 acquire()
+};
+
+#endif // IATCONNECTIONPOOL_H
@@ -0,0 +1,12 @@
+#include "iatCredentials.h"
+
+#include <QtGlobal>
+
+IatCredentials IatCredentials::fromEnvironment()
+{
+    IatCredentials credentials;
+    credentials.appId = qEnvironmentVariable("IAT_APP_ID");
+    credentials.apiKey = qEnvironmentVariable("IAT_API_KEY");
+    credentials.apiSecret = qEnvironmentVariable("IAT_API_SECRET");
+    return credentials;
+}
@@ -0,0 +1,25 @@
+#ifndef IATCREDENTIALS_H
+#define IATCREDENTIALS_H
+
+#include <QString>
+
+// 讯飞开放平台的应用凭据
+// 默认从环境变量 IAT_APP_ID / IAT_API_KEY / IAT_API_SECRET 读取，避免写死在代码里。
+struct IatCredentials
+{
+    QString appId;
+    QString apiKey;
+    QString apiSecret;
+
+    bool isComplete() const { return !appId.isEmpty() && !apiKey.isEmpty() && !apiSecret.isEmpty(); }
+
+    bool operator==(const IatCredentials &other) const
+    {
+        return appId == other.appId && apiKey == other.apiKey && apiSecret == other.apiSecret;
+    }
+    bool operator!=(const IatCredentials &other) const { return !(*this == other); }
+
+    static IatCredentials fromEnvironment();
+};
+
+#endif // IATCREDENTIALS_H
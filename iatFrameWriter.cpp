@@ -0,0 +1,137 @@
+#include "iatFrameWriter.h"
+#include "base64Encoder.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstring>
+
+namespace {
+constexpr char DATA_STATUS_KEY[] = R"("data":{"status":)";
+constexpr char AUDIO_KEY[] = R"("audio":")";
+
+QByteArray dataPrefix(FrameStatus status, const QByteArray &encoding)
+{
+    // format 描述编码前的音频，压缩编码时同样是 16k 采样率
+    return QByteArray(R"("data":{"status":)") + QByteArray::number(int(status))
+           + R"(,"format":"audio/L16;rate=16000","encoding":")" + encoding + R"(","audio":")";
+}
+
+QJsonObject businessObject()
+{
+    QJsonObject business;
+    business["language"] = "zh_cn";
+    business["domain"] = "iat";
+    business["accent"] = "mandarin";
+    business["vad_eos"] = 10000;
+    business["dwa"] = "wpgs";
+    business["pd"] = "game";
+    business["ptt"] = 1;
+    business["rlang"] = "zh-cn";
+    business["vinfo"] = 1;
+    business["nunum"] = 1;
+    business["speex_size"] = 70;
+    business["nbest"] = 1;
+    business["wbest"] = 1;
+    return business;
+}
+}
+
+QByteArray IatFrameWriter::businessParameters()
+{
+    return QJsonDocument(businessObject()).toJson(QJsonDocument::Compact);
+}
+
+IatFrameWriter::IatFrameWriter(const QString &appId)
+    : m_encoding("raw")
+{
+    m_suffix = R"("}})";
+    setAppId(appId);
+}
+
+void IatFrameWriter::setEncoding(const QByteArray &encoding)
+{
+    m_encoding = encoding;
+    buildPrefixes();
+}
+
+void IatFrameWriter::setAppId(const QString &appId)
+{
+    QJsonObject json;
+
+    // 公共参数
+    QJsonObject common;
+    common["app_id"] = appId;
+    json["common"] = common;
+
+    // 业务参数
+    json["business"] = businessObject();
+
+    // 第一帧：去掉结尾的 '}'，接上 data 字段
+    m_header = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    m_header.chop(1);
+    buildPrefixes();
+}
+
+void IatFrameWriter::buildPrefixes()
+{
+    m_prefixes[STATUS_FIRST_FRAME] = m_header + "," + dataPrefix(STATUS_FIRST_FRAME, m_encoding);
+    m_prefixes[STATUS_CONTINUE_FRAME] = "{" + dataPrefix(STATUS_CONTINUE_FRAME, m_encoding);
+    m_prefixes[STATUS_LAST_FRAME] = "{" + dataPrefix(STATUS_LAST_FRAME, m_encoding);
+}
+
+qsizetype IatFrameWriter::maxFrameSize(qsizetype audioSize) const
+{
+    return m_prefixes[STATUS_FIRST_FRAME].size() + base64EncodedSize(audioSize) + m_suffix.size();
+}
+
+void IatFrameWriter::writeFrame(QByteArray &out, FrameStatus status, QByteArrayView audio) const
+{
+    const QByteArray &prefix = m_prefixes[status];
+    const qsizetype audioSize = base64EncodedSize(audio.size());
+
+    // Qt 6 中 resize() 不会缩小容量，复用的缓冲区在这里不会重新分配
+    out.resize(prefix.size() + audioSize + m_suffix.size());
+    char *dst = out.data();
+
+    memcpy(dst, prefix.constData(), prefix.size());
+    dst += prefix.size();
+    dst += base64Encode(audio.data(), audio.size(), dst);
+    memcpy(dst, m_suffix.constData(), m_suffix.size());
+}
+
+QByteArrayView IatFrameWriter::frameHeader(QByteArrayView firstFrame)
+{
+    const qsizetype pos = firstFrame.indexOf(DATA_STATUS_KEY);
+    return pos < 0 ? QByteArrayView() : firstFrame.first(pos);
+}
+
+QByteArray IatFrameWriter::rewriteFrame(QByteArrayView message, FrameStatus status, QByteArrayView header,
+                                        bool withAudio)
+{
+    // 消息格式固定为 [header]"data":{"status":N,...,"audio":"...."}}，只替换 data 之前的部分和状态数字
+    const qsizetype dataPos = message.indexOf(DATA_STATUS_KEY);
+    if (dataPos < 0) {
+        return message.toByteArray();
+    }
+    const QByteArrayView rest = message.sliced(dataPos + qsizetype(sizeof(DATA_STATUS_KEY) - 1) + 1);
+
+    QByteArray out;
+    out.reserve(header.size() + message.size());
+    if (status == STATUS_FIRST_FRAME) {
+        out.append(header);
+    } else {
+        out.append('{');
+    }
+    out.append(DATA_STATUS_KEY);
+    out.append(char('0' + int(status)));
+
+    const qsizetype audioPos = rest.indexOf(AUDIO_KEY);
+    if (withAudio || audioPos < 0) {
+        out.append(rest);
+    } else {
+        out.append(rest.first(audioPos + qsizetype(sizeof(AUDIO_KEY) - 1)));
+        out.append(R"("}})");
+    }
+    return out;
+}
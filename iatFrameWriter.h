@@ -0,0 +1,49 @@
+#ifndef IATFRAMEWRITER_H
+#define IATFRAMEWRITER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+#include "iatProtocol.h"
+
+// 上行帧序列化器：直接向预分配的字节缓冲区输出紧凑 JSON
+// 不变的部分 (common/business 参数、format/encoding 字段) 在构造时预先生成，
+// 每帧只需拷贝前缀、就地写入 base64 音频并追加后缀。
+// 输出缓冲区容量足够时不产生任何堆分配，可在会话内反复使用。
+class IatFrameWriter
+{
+public:
+    explicit IatFrameWriter(const QString &appId = QString());
+
+    // 更换 app_id 时重新生成第一帧前缀
+    void setAppId(const QString &appId);
+
+    // 帧头的 encoding 字段 (audioEncodingName())，默认 raw
+    void setEncoding(const QByteArray &encoding);
+
+    // 按帧状态生成完整消息，覆盖 out 原有内容；audio 为编码后的音频数据
+    void writeFrame(QByteArray &out, FrameStatus status, QByteArrayView audio) const;
+
+    // 第一帧中的 business 参数 (紧凑 JSON)，识别结果缓存用它区分不同的识别设置
+    static QByteArray businessParameters();
+
+    // 一帧消息的最大长度，用于预分配缓冲区
+    qsizetype maxFrameSize(qsizetype audioSize) const;
+
+    // 断线重放：取出会话第一帧中 data 字段之前的 common/business 部分
+    static QByteArrayView frameHeader(QByteArrayView firstFrame);
+    // 把已编码的消息改写为另一帧状态，音频保持不变；withAudio 为 false 时生成空音频帧
+    static QByteArray rewriteFrame(QByteArrayView message, FrameStatus status, QByteArrayView header,
+                                   bool withAudio = true);
+
+private:
+    void buildPrefixes();
+
+    QByteArray m_header;       // common/business 参数，去掉了结尾的 '}'
+    QByteArray m_encoding;
+    QByteArray m_prefixes[3];  // 按 FrameStatus 索引，以 "audio":" 结尾
+    QByteArray m_suffix;
+};
+
+#endif // IATFRAMEWRITER_H
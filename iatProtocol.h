@@ -0,0 +1,80 @@
+#ifndef IATPROTOCOL_H
+#define IATPROTOCOL_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
+
+// 讯飞听写 (IAT) 流式接口的音频参数和帧定义，供流水线各阶段共用
+
+constexpr int SAMPLE_RATE = 16000;
+constexpr int BYTES_PER_MS = SAMPLE_RATE * 2 / 1000;  // 16k采样率 16bit 单声道每毫秒字节数
+
+// 每帧音频时长在运行时设置，也可由网络阶段按往返时延和发送积压自动调整
+constexpr int MIN_FRAME_MS = 40;
+constexpr int MAX_FRAME_MS = 400;
+constexpr int DEFAULT_FRAME_MS = 40;  // 服务建议每 40ms 发送一次音频
+constexpr int MAX_FRAME_SIZE = MAX_FRAME_MS * BYTES_PER_MS;  // 单帧上限 12800 字节 (16k采样率 * 400ms * 2字节)
+
+// 按语音活动检测的 20ms 分析块对齐，并限制在 [MIN_FRAME_MS, MAX_FRAME_MS] 内
+constexpr int boundFrameMs(int msecs)
+{
+    const int aligned = (msecs + 10) / 20 * 20;
+    return aligned < MIN_FRAME_MS ? MIN_FRAME_MS : (aligned > MAX_FRAME_MS ? MAX_FRAME_MS : aligned);
+}
+
+// 长音频分段：服务限制单次会话的音频时长，预处理阶段在接近上限前于停顿处切分，
+// 网络阶段为每段换用一条预先建立的连接，并把各段的结果序号错开后拼接
+constexpr int SEGMENT_SOFT_LIMIT_MS = 45000;  // 已发送音频超过此时长后，在下一个停顿处切分
+constexpr int SEGMENT_HARD_LIMIT_MS = 55000;  // 一直没有停顿时在此强制切分 (服务上限 60s)
+constexpr int SEGMENT_OVERLAP_MS = 400;       // 强制切分时在下一段开头重复发送的音频时长
+constexpr int SEGMENT_SN_STRIDE = 10000;      // 第 n 段的结果序号加上 n * SEGMENT_SN_STRIDE
+
+constexpr char IAT_ENDPOINT[] = "wss://iat-api.xfyun.cn/v2/iat";  // 默认服务地址
+
+enum FrameStatus {
+    STATUS_FIRST_FRAME = 0,
+    STATUS_CONTINUE_FRAME = 1,
+    STATUS_LAST_FRAME = 2
+};
+
+// 预处理后的 16k 单声道 Int16 PCM 帧
+struct AudioFrame
+{
+    QByteArray pcm;
+    bool last = false;  // 音频流的最后一帧，pcm 可能为空
+    bool segmentEnd = false;  // 本段的最后一帧，之后的帧属于新会话；在停顿处切分时 pcm 为空
+    bool overlap = false;  // 强制切分后重复发送的上一段末尾音频，作为新一段的开头
+    qint64 capturedAtNs = 0;  // 帧凑满的时刻 (PipelineMetrics::now())，补发的静音帧为 0
+};
+
+// 编码完成、可直接发送的 JSON 文本帧
+struct EncodedFrame
+{
+    QByteArray message;       // last 且为空时表示音频流在两段之间结束，没有要发送的消息
+    bool last = false;
+    bool first = false;       // 会话的第一帧 (STATUS_FIRST_FRAME)
+    bool segmentEnd = false;  // 本段的结束帧，之后换用新连接
+    bool overlap = false;     // 第一帧的音频与上一段末尾重复
+    int audioMs = 0;          // 帧内音频时长，用于断线重放
+    qint64 capturedAtNs = 0;
+    qint64 emittedAtNs = 0;  // 编码完成的时刻
+};
+
+// 一条识别结果 (开启 wpgs 动态修正)
+// pgs 为 apd 时追加到已有结果之后；为 rpl 时替换序号在 [replaceFirst, replaceLast] 内的结果。
+struct RecognitionResult
+{
+    int sn = 0;             // 结果序号，从 1 开始；长音频分段后按 SEGMENT_SN_STRIDE 错开
+    bool replace = false;   // pgs == "rpl"
+    int replaceFirst = 0;   // rg 范围，仅 replace 时有效
+    int replaceLast = 0;
+    bool last = false;      // ls：本次会话的最后一条结果
+    bool overlapsPrevious = false;  // 所在分段以上一段的末尾音频开头，拼接时去掉重复的文字
+    int beginMs = -1;       // 第一个词在本次会话音频中的起始时间 (vinfo)，没有词时为 -1
+    QString text;
+};
+
+Q_DECLARE_METATYPE(RecognitionResult)
+
+#endif // IATPROTOCOL_H
@@ -0,0 +1,559 @@
+#include "iatResultParser.h"
+
+#include <cstring>
+
+namespace {
+constexpr int MAX_SKIP_DEPTH = 64;
+constexpr char16_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// 从游标位置读取 JSON 值的最小化读取器，Char 为 char (UTF-8) 或 char16_t (UTF-16)
+template<typename Char>
+class JsonReader
+{
+public:
+    JsonReader(const Char *begin, const Char *end) : m_p(begin), m_end(end) {}
+
+    bool failed() const { return m_error != nullptr; }
+    const char *error() const { return m_error; }
+    qsizetype offset(const Char *begin) const { return m_p - begin; }
+
+    bool beginObject() { return expect('{'); }
+    // 下一个值是否为对象，不移动游标
+    bool atObject()
+    {
+        skipSpace();
+        return m_p < m_end && *m_p == '{';
+    }
+    bool beginArray() { return expect('['); }
+
+    // 读取下一个键；遇到 '}' 时消费它并返回 false。键只在本协议中出现 ASCII，返回原始字符区间
+    bool nextKey(const Char *&keyBegin, const Char *&keyEnd)
+    {
+        if (!nextMember('}')) {
+            return false;
+        }
+        if (!readRawString(keyBegin, keyEnd) || !expect(':')) {
+            return false;
+        }
+        return true;
+    }
+
+    // 移动到数组的下一个元素；遇到 ']' 时消费它并返回 false
+    bool nextElement() { return nextMember(']'); }
+
+    bool readInt(qint64 &value)
+    {
+        skipSpace();
+        const bool negative = m_p < m_end && *m_p == '-';
+        if (negative) {
+            ++m_p;
+        }
+        if (m_p >= m_end || *m_p < '0' || *m_p > '9') {
+            return fail("expected number");
+        }
+        qint64 result = 0;
+        while (m_p < m_end && *m_p >= '0' && *m_p <= '9') {
+            result = result * 10 + (*m_p - '0');
+            ++m_p;
+        }
+        // 小数和指数部分对本协议的字段没有意义，直接跳过
+        while (m_p < m_end && (*m_p == '.' || *m_p == 'e' || *m_p == 'E' || *m_p == '+' || *m_p == '-'
+                               || (*m_p >= '0' && *m_p <= '9'))) {
+            ++m_p;
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    bool readBool(bool &value)
+    {
+        skipSpace();
+        if (matchLiteral("true")) {
+            value = true;
+            return true;
+        }
+        if (matchLiteral("false")) {
+            value = false;
+            return true;
+        }
+        return fail("expected boolean");
+    }
+
+    // 不处理转义，返回引号之间的原始字符
+    bool readRawString(const Char *&begin, const Char *&end)
+    {
+        if (!expect('"')) {
+            return false;
+        }
+        begin = m_p;
+        while (m_p < m_end && *m_p != '"') {
+            m_p += (*m_p == '\\') ? 2 : 1;
+        }
+        if (m_p >= m_end) {
+            return fail("unterminated string");
+        }
+        end = m_p++;
+        return true;
+    }
+
+    // 解码字符串并追加到 out，处理转义和 UTF-8
+    bool appendString(QString &out)
+    {
+        if (!expect('"')) {
+            return false;
+        }
+        for (;;) {
+            const Char *run = m_p;
+            while (m_p < m_end && *m_p != '"' && *m_p != '\\') {
+                ++m_p;
+            }
+            appendRun(out, run, m_p);
+            if (m_p >= m_end) {
+                return fail("unterminated string");
+            }
+            if (*m_p == '"') {
+                ++m_p;
+                return true;
+            }
+            if (!appendEscape(out)) {
+                return false;
+            }
+        }
+    }
+
+    bool readString(QString &out)
+    {
+        out.resize(0);  // 保留容量
+        return appendString(out);
+    }
+
+    bool skipValue(int depth = 0)
+    {
+        if (depth > MAX_SKIP_DEPTH) {
+            return fail("nesting too deep");
+        }
+        skipSpace();
+        if (m_p >= m_end) {
+            return fail("unexpected end of message");
+        }
+        switch (*m_p) {
+        case '{': {
+            ++m_p;
+            const Char *keyBegin;
+            const Char *keyEnd;
+            while (nextKey(keyBegin, keyEnd)) {
+                if (!skipValue(depth + 1)) {
+                    return false;
+                }
+            }
+            return !failed();
+        }
+        case '[':
+            ++m_p;
+            while (nextElement()) {
+                if (!skipValue(depth + 1)) {
+                    return false;
+                }
+            }
+            return !failed();
+        case '"': {
+            const Char *begin;
+            const Char *end;
+            return readRawString(begin, end);
+        }
+        case 't':
+        case 'f': {
+            bool value;
+            return readBool(value);
+        }
+        case 'n':
+            return matchLiteral("null") || fail("unexpected token");
+        default: {
+            qint64 value;
+            return readInt(value);
+        }
+        }
+    }
+
+    static bool keyIs(const Char *begin, const Char *end, const char *literal)
+    {
+        const qsizetype length = qsizetype(strlen(literal));
+        if (end - begin != length) {
+            return false;
+        }
+        for (qsizetype i = 0; i < length; ++i) {
+            if (begin[i] != Char(literal[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    void skipSpace()
+    {
+        while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) {
+            ++m_p;
+        }
+    }
+
+    bool fail(const char *error)
+    {
+        if (!m_error) {
+            m_error = error;
+        }
+        m_p = m_end;
+        return false;
+    }
+
+    bool expect(char c)
+    {
+        skipSpace();
+        if (m_p >= m_end || *m_p != Char(c)) {
+            return fail("unexpected token");
+        }
+        ++m_p;
+        return true;
+    }
+
+    // 对象/数组成员之间的逗号处理，第一个成员之前没有逗号
+    bool nextMember(char close)
+    {
+        if (failed()) {
+            return false;
+        }
+        skipSpace();
+        if (m_p < m_end && *m_p == Char(close)) {
+            ++m_p;
+            return false;
+        }
+        if (m_p < m_end && *m_p == ',') {
+            ++m_p;
+        }
+        return m_p < m_end || fail("unexpected end of message");
+    }
+
+    bool matchLiteral(const char *literal)
+    {
+        const qsizetype length = qsizetype(strlen(literal));
+        if (m_end - m_p < length || !keyIs(m_p, m_p + length, literal)) {
+            return false;
+        }
+        m_p += length;
+        return true;
+    }
+
+    static int hexValue(Char c)
+    {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    bool appendEscape(QString &out)
+    {
+        ++m_p;  // 反斜杠
+        if (m_p >= m_end) {
+            return fail("unterminated escape");
+        }
+        const Char c = *m_p++;
+        switch (c) {
+        case '"': out.append(QChar(u'"')); return true;
+        case '\\': out.append(QChar(u'\\')); return true;
+        case '/': out.append(QChar(u'/')); return true;
+        case 'b': out.append(QChar(u'\b')); return true;
+        case 'f': out.append(QChar(u'\f')); return true;
+        case 'n': out.append(QChar(u'\n')); return true;
+        case 'r': out.append(QChar(u'\r')); return true;
+        case 't': out.append(QChar(u'\t')); return true;
+        case 'u': {
+            if (m_end - m_p < 4) {
+                return fail("truncated unicode escape");
+            }
+            int code = 0;
+            for (int i = 0; i < 4; ++i) {
+                const int digit = hexValue(m_p[i]);
+                if (digit < 0) {
+                    return fail("invalid unicode escape");
+                }
+                code = code * 16 + digit;
+            }
+            m_p += 4;
+            // 代理对由两个 \u 转义组成，逐个追加后在 UTF-16 中自然成对
+            out.append(QChar(char16_t(code)));
+            return true;
+        }
+        default:
+            return fail("invalid escape");
+        }
+    }
+
+    static void appendRun(QString &out, const char16_t *begin, const char16_t *end)
+    {
+        if (begin != end) {
+            out.append(QStringView(begin, end - begin));
+        }
+    }
+
+    // UTF-8 直接解码到 out 的存储中，UTF-16 长度不会超过 UTF-8 字节数
+    static void appendRun(QString &out, const char *begin, const char *end)
+    {
+        if (begin == end) {
+            return;
+        }
+        const qsizetype start = out.size();
+        out.resize(start + (end - begin));
+        char16_t *dst = reinterpret_cast<char16_t *>(out.data()) + start;
+        char16_t *const dstBegin = dst;
+
+        const uchar *p = reinterpret_cast<const uchar *>(begin);
+        const uchar *const stop = reinterpret_cast<const uchar *>(end);
+        while (p < stop) {
+            const uchar lead = *p;
+            if (lead < 0x80) {
+                *dst++ = lead;
+                ++p;
+                continue;
+            }
+
+            int extra = 0;
+            char32_t code = 0;
+            if ((lead & 0xE0) == 0xC0) {
+                extra = 1;
+                code = lead & 0x1F;
+            } else if ((lead & 0xF0) == 0xE0) {
+                extra = 2;
+                code = lead & 0x0F;
+            } else if ((lead & 0xF8) == 0xF0) {
+                extra = 3;
+                code = lead & 0x07;
+            } else {
+                *dst++ = REPLACEMENT_CHARACTER;
+                ++p;
+                continue;
+            }
+
+            bool valid = stop - p > extra;
+            for (int i = 1; valid && i <= extra; ++i) {
+                valid = (p[i] & 0xC0) == 0x80;
+                code = (code << 6) | (p[i] & 0x3F);
+            }
+            if (!valid) {
+                *dst++ = REPLACEMENT_CHARACTER;
+                ++p;
+                continue;
+            }
+            p += extra + 1;
+
+            if (code >= 0x10000) {
+                code -= 0x10000;
+                *dst++ = char16_t(0xD800 + (code >> 10));
+                *dst++ = char16_t(0xDC00 + (code & 0x3FF));
+            } else {
+                *dst++ = char16_t(code);
+            }
+        }
+        out.resize(start + (dst - dstBegin));
+    }
+
+    const Char *m_p;
+    const Char *const m_end;
+    const char *m_error = nullptr;
+};
+
+template<typename Char>
+bool parseWords(JsonReader<Char> &reader, RecognitionResult &result)
+{
+    // ws: [{ "bg": 0, "cw": [{ "w": "...", "sc": 0 }] }]，bg 为词的起始帧 (10ms)
+    const Char *keyBegin;
+    const Char *keyEnd;
+    if (!reader.beginArray()) {
+        return false;
+    }
+    while (reader.nextElement()) {
+        if (!reader.beginObject()) {
+            return false;
+        }
+        while (reader.nextKey(keyBegin, keyEnd)) {
+            if (JsonReader<Char>::keyIs(keyBegin, keyEnd, "bg") && result.beginMs < 0) {
+                qint64 frames = 0;
+                if (!reader.readInt(frames)) {
+                    return false;
+                }
+                result.beginMs = int(frames) * 10;
+                continue;
+            }
+            if (!JsonReader<Char>::keyIs(keyBegin, keyEnd, "cw")) {
+                if (!reader.skipValue()) {
+                    return false;
+                }
+                continue;
+            }
+            if (!reader.beginArray()) {
+                return false;
+            }
+            while (reader.nextElement()) {
+                if (!reader.beginObject()) {
+                    return false;
+                }
+                while (reader.nextKey(keyBegin, keyEnd)) {
+                    const bool ok = JsonReader<Char>::keyIs(keyBegin, keyEnd, "w") ? reader.appendString(result.text)
+                                                                                   : reader.skipValue();
+                    if (!ok) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return !reader.failed();
+}
+
+template<typename Char>
+bool parseResult(JsonReader<Char> &reader, IatResponse &response)
+{
+    RecognitionResult &result = response.result;
+    const Char *keyBegin;
+    const Char *keyEnd;
+    // "result":null 等非对象值与缺少该字段相同
+    if (!reader.atObject()) {
+        return reader.skipValue();
+    }
+    if (!reader.beginObject()) {
+        return false;
+    }
+    while (reader.nextKey(keyBegin, keyEnd)) {
+        using R = JsonReader<Char>;
+        qint64 number = 0;
+        bool ok = true;
+        if (R::keyIs(keyBegin, keyEnd, "sn")) {
+            ok = reader.readInt(number);
+            result.sn = int(number);
+        } else if (R::keyIs(keyBegin, keyEnd, "ls")) {
+            ok = reader.readBool(result.last);
+        } else if (R::keyIs(keyBegin, keyEnd, "pgs")) {
+            const Char *valueBegin;
+            const Char *valueEnd;
+            ok = reader.readRawString(valueBegin, valueEnd);
+            result.replace = ok && R::keyIs(valueBegin, valueEnd, "rpl");
+        } else if (R::keyIs(keyBegin, keyEnd, "rg")) {
+            ok = reader.beginArray();
+            for (int i = 0; ok && reader.nextElement(); ++i) {
+                ok = reader.readInt(number);
+                if (i == 0) {
+                    result.replaceFirst = int(number);
+                } else if (i == 1) {
+                    result.replaceLast = int(number);
+                }
+            }
+            ok = ok && !reader.failed();
+        } else if (R::keyIs(keyBegin, keyEnd, "ws")) {
+            response.hasResult = true;
+            ok = parseWords(reader, result);
+        } else {
+            ok = reader.skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return !reader.failed();
+}
+
+template<typename Char>
+bool parseData(JsonReader<Char> &reader, IatResponse &response)
+{
+    const Char *keyBegin;
+    const Char *keyEnd;
+    // 错误响应中的 "data":null 等非对象值视为不存在
+    if (!reader.atObject()) {
+        return reader.skipValue();
+    }
+    if (!reader.beginObject()) {
+        return false;
+    }
+    while (reader.nextKey(keyBegin, keyEnd)) {
+        using R = JsonReader<Char>;
+        bool ok;
+        if (R::keyIs(keyBegin, keyEnd, "status")) {
+            qint64 status = 0;
+            ok = reader.readInt(status);
+            response.status = int(status);
+        } else if (R::keyIs(keyBegin, keyEnd, "result")) {
+            ok = parseResult(reader, response);
+        } else {
+            ok = reader.skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return !reader.failed();
+}
+}
+
+template<typename Char>
+bool IatResultParser::parseMessage(const Char *begin, const Char *end, IatResponse &response)
+{
+    // 复位输出，字符串只清空内容、保留容量
+    response.code = 0;
+    response.message.resize(0);
+    response.sid.resize(0);
+    response.status = -1;
+    response.hasResult = false;
+    response.result.sn = 0;
+    response.result.replace = false;
+    response.result.replaceFirst = 0;
+    response.result.replaceLast = 0;
+    response.result.last = false;
+    response.result.overlapsPrevious = false;
+    response.result.beginMs = -1;
+    response.result.text.resize(0);
+
+    JsonReader<Char> reader(begin, end);
+    const Char *keyBegin;
+    const Char *keyEnd;
+    bool ok = reader.beginObject();
+    while (ok && reader.nextKey(keyBegin, keyEnd)) {
+        using R = JsonReader<Char>;
+        if (R::keyIs(keyBegin, keyEnd, "code")) {
+            qint64 code = 0;
+            ok = reader.readInt(code);
+            response.code = int(code);
+        } else if (R::keyIs(keyBegin, keyEnd, "message")) {
+            ok = reader.readString(response.message);
+        } else if (R::keyIs(keyBegin, keyEnd, "sid")) {
+            ok = reader.readString(response.sid);
+        } else if (R::keyIs(keyBegin, keyEnd, "data")) {
+            ok = parseData(reader, response);
+        } else {
+            ok = reader.skipValue();
+        }
+    }
+
+    if (!ok || reader.failed()) {
+        m_error = QString("%1 at offset %2")
+                      .arg(QLatin1String(reader.error() ? reader.error() : "malformed message"))
+                      .arg(reader.offset(begin));
+        return false;
+    }
+    m_error.clear();
+    return true;
+}
+
+bool IatResultParser::parse(QStringView message, IatResponse &response)
+{
+    return parseMessage(message.utf16(), message.utf16() + message.size(), response);
+}
+
+bool IatResultParser::parse(QByteArrayView utf8, IatResponse &response)
+{
+    return parseMessage(utf8.data(), utf8.data() + utf8.size(), response);
+}
@@ -0,0 +1,43 @@
+#ifndef IATRESULTPARSER_H
+#define IATRESULTPARSER_H
+
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+
+#include "iatProtocol.h"
+
+// 听写服务返回的一条消息中用到的字段
+struct IatResponse
+{
+    int code = 0;
+    QString message;
+    QString sid;
+    int status = -1;         // data.status，缺失时为 -1
+    bool hasResult = false;  // data.result 中带有 ws 词语列表
+    RecognitionResult result;
+};
+
+// 面向 IAT 返回消息的流式 JSON 解析器
+// 顺序扫描一遍消息，只取出 code/message/sid/status/sn/ls/pgs/rg 和 ws[].cw[].w，
+// 其余字段直接跳过，不构建 QJsonDocument，也不需要先把 QString 转成 UTF-8。
+// 输出结构可以反复传入复用，文本缓冲区的容量会被保留。
+class IatResultParser
+{
+public:
+    // QWebSocket 给出的 UTF-16 文本
+    bool parse(QStringView message, IatResponse &response);
+    // UTF-8 数据，例如录制的响应文件
+    bool parse(QByteArrayView utf8, IatResponse &response);
+
+    // 最近一次解析失败的原因
+    QString errorString() const { return m_error; }
+
+private:
+    template<typename Char>
+    bool parseMessage(const Char *begin, const Char *end, IatResponse &response);
+
+    QString m_error;
+};
+
+#endif // IATRESULTPARSER_H
@@ -0,0 +1,223 @@
+#include "pipelineMetrics.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <chrono>
+
+namespace {
+struct MetricInfo
+{
+    const char *name;
+    const char *help;
+};
+
+const MetricInfo COUNTERS[PipelineMetrics::CounterCount] = {
+    { "frames_captured", "Audio frames cut from the capture stream" },
+    { "frames_silent", "Frames skipped by voice activity detection" },
+    { "frames_sent", "Frames written to the WebSocket" },
+    { "bytes_uploaded", "JSON message bytes written to the WebSocket" },
+    { "results_received", "Recognition result messages received" },
+    { "server_errors", "Responses with a non-zero error code" },
+    { "connection_errors", "Failed handshakes and dropped connections" },
+    { "sessions_started", "Recognition sessions started" },
+    { "sessions_completed", "Sessions that received a final result" },
+    { "reconnects", "Reconnects after a dropped connection" },
+    { "frames_replayed", "Frames re-sent after reconnecting" },
+    { "archive_bytes_written", "Audio bytes written to session archives" },
+    { "archive_bytes_dropped", "Audio bytes not archived because the writer fell behind" },
+};
+
+const MetricInfo HISTOGRAMS[PipelineMetrics::HistogramCount] = {
+    { "capture_to_emit_ms", "Frame complete to frame encoded" },
+    { "emit_to_write_ms", "Frame encoded to socket write" },
+    { "capture_to_write_ms", "Frame complete to socket write" },
+    { "write_to_result_ms", "Latest socket write to recognition result" },
+    { "first_result_ms", "Session start to first recognition result" },
+    { "final_result_ms", "Last frame written to final result" },
+    { "reconnect_ms", "Connection lost to replay complete" },
+};
+
+constexpr char PREFIX[] = "speech_";
+
+QByteArray formatBound(double bound)
+{
+    return QByteArray::number(bound, 'g', 6);
+}
+}
+
+const double MetricHistogram::BOUNDS_MS[BOUND_COUNT] = {
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000
+};
+
+void MetricHistogram::record(double ms)
+{
+    int index = 0;
+    while (index < BOUND_COUNT && ms > BOUNDS_MS[index]) {
+        ++index;
+    }
+    m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumUs.fetch_add(quint64(qMax(0.0, ms) * 1000.0), std::memory_order_relaxed);
+}
+
+void MetricHistogram::reset()
+{
+    for (std::atomic<quint64> &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sumUs.store(0, std::memory_order_relaxed);
+}
+
+double MetricHistogram::quantile(double q) const
+{
+    quint64 counts[BOUND_COUNT + 1];
+    quint64 total = 0;
+    for (int i = 0; i <= BOUND_COUNT; ++i) {
+        counts[i] = bucket(i);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    const double rank = qBound(0.0, q, 1.0) * total;
+    quint64 seen = 0;
+    for (int i = 0; i <= BOUND_COUNT; ++i) {
+        if (counts[i] > 0 && seen + counts[i] >= rank) {
+            // +Inf 桶没有上界，返回最大的有限上界
+            if (i == BOUND_COUNT) {
+                return BOUNDS_MS[BOUND_COUNT - 1];
+            }
+            const double lower = i == 0 ? 0.0 : BOUNDS_MS[i - 1];
+            return lower + (BOUNDS_MS[i] - lower) * (rank - seen) / counts[i];
+        }
+        seen += counts[i];
+    }
+    return BOUNDS_MS[BOUND_COUNT - 1];
+}
+
+qint64 PipelineMetrics::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PipelineMetrics::record(Histogram histogram, qint64 startNs, qint64 endNs)
+{
+    if (startNs <= 0) {
+        return;
+    }
+    m_histograms[histogram].record((endNs - startNs) / 1e6);
+}
+
+void PipelineMetrics::reset()
+{
+    for (std::atomic<quint64> &counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (MetricHistogram &histogram : m_histograms) {
+        histogram.reset();
+    }
+}
+
+const char *PipelineMetrics::counterName(Counter counter)
+{
+    return COUNTERS[counter].name;
+}
+
+const char *PipelineMetrics::histogramName(Histogram histogram)
+{
+    return HISTOGRAMS[histogram].name;
+}
+
+QByteArray PipelineMetrics::toPrometheus() const
+{
+    QByteArray out;
+
+    for (int i = 0; i < CounterCount; ++i) {
+        const QByteArray name = PREFIX + QByteArray(COUNTERS[i].name) + "_total";
+        out += "# HELP " + name + " " + COUNTERS[i].help + "\n";
+        out += "# TYPE " + name + " counter\n";
+        out += name + " " + QByteArray::number(counter(Counter(i))) + "\n";
+    }
+
+    for (int i = 0; i < HistogramCount; ++i) {
+        const MetricHistogram &h = m_histograms[i];
+        const QByteArray name = PREFIX + QByteArray(HISTOGRAMS[i].name);
+        out += "# HELP " + name + " " + HISTOGRAMS[i].help + "\n";
+        out += "# TYPE " + name + " histogram\n";
+
+        // Prometheus 的桶是累计计数
+        quint64 cumulative = 0;
+        for (int b = 0; b < MetricHistogram::BOUND_COUNT; ++b) {
+            cumulative += h.bucket(b);
+            out += name + "_bucket{le=\"" + formatBound(MetricHistogram::BOUNDS_MS[b]) + "\"} "
+                   + QByteArray::number(cumulative) + "\n";
+        }
+        cumulative += h.bucket(MetricHistogram::BOUND_COUNT);
+        out += name + "_bucket{le=\"+Inf\"} " + QByteArray::number(cumulative) + "\n";
+        out += name + "_sum " + QByteArray::number(h.sumMs(), 'f', 3) + "\n";
+        out += name + "_count " + QByteArray::number(cumulative) + "\n";
+    }
+    return out;
+}
+
+QByteArray PipelineMetrics::toJson() const
+{
+    QJsonObject counters;
+    for (int i = 0; i < CounterCount; ++i) {
+        counters[COUNTERS[i].name] = qint64(counter(Counter(i)));
+    }
+
+    QJsonArray bounds;
+    for (double bound : MetricHistogram::BOUNDS_MS) {
+        bounds.append(bound);
+    }
+
+    QJsonObject histograms;
+    for (int i = 0; i < HistogramCount; ++i) {
+        const MetricHistogram &h = m_histograms[i];
+        QJsonArray buckets;
+        for (int b = 0; b <= MetricHistogram::BOUND_COUNT; ++b) {
+            buckets.append(qint64(h.bucket(b)));
+        }
+        QJsonObject entry;
+        entry["count"] = qint64(h.count());
+        entry["sum"] = h.sumMs();
+        entry["p50"] = h.quantile(0.50);
+        entry["p95"] = h.quantile(0.95);
+        entry["p99"] = h.quantile(0.99);
+        entry["buckets"] = buckets;  // 最后一个为 +Inf 桶，非累计
+        histograms[HISTOGRAMS[i].name] = entry;
+    }
+
+    QJsonObject root;
+    root["counters"] = counters;
+    root["bucket_bounds_ms"] = bounds;
+    root["histograms"] = histograms;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+bool PipelineMetrics::writeSnapshot(const QString &path, QString *error) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    file.write(path.endsWith(".json", Qt::CaseInsensitive) ? toJson() : toPrometheus());
+    if (!file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
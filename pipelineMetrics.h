@@ -0,0 +1,95 @@
+#ifndef PIPELINEMETRICS_H
+#define PIPELINEMETRICS_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+
+// 固定分桶的延迟直方图 (毫秒)，记录和读取都是无锁的
+// 桶上界按 1-2-5 递增，覆盖 1ms 到 10s，超出部分落入最后的 +Inf 桶。
+class MetricHistogram
+{
+public:
+    static constexpr int BOUND_COUNT = 13;
+    static const double BOUNDS_MS[BOUND_COUNT];
+
+    void record(double ms);
+    void reset();
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    double sumMs() const { return m_sumUs.load(std::memory_order_relaxed) / 1000.0; }
+    // index == BOUND_COUNT 为 +Inf 桶，不累计
+    quint64 bucket(int index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+    // 在桶内线性插值估算分位数，没有样本时返回 0
+    double quantile(double q) const;
+
+private:
+    std::atomic<quint64> m_buckets[BOUND_COUNT + 1] = {};
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sumUs{0};
+};
+
+// 识别流水线的计数器和延迟直方图
+// 各阶段在自己的线程中直接更新，读取方 (界面、导出) 随时取快照，互不加锁。
+// 时间戳统一使用 now() 返回的单调时钟纳秒值，可以跨线程相减。
+class PipelineMetrics
+{
+public:
+    enum Counter {
+        FramesCaptured,     // 预处理切出的完整音频帧
+        FramesSilent,       // 被语音活动检测跳过的帧
+        FramesSent,
+        BytesUploaded,      // 发送的 JSON 消息字节数
+        ResultsReceived,
+        ServerErrors,       // 服务端返回的非 0 错误码
+        ConnectionErrors,   // 握手失败、连接异常断开
+        SessionsStarted,
+        SessionsCompleted,  // 收到最终结果的会话
+        Reconnects,         // 连接意外断开后重连的次数
+        FramesReplayed,     // 重连后补发的帧
+        ArchiveBytesWritten,  // 写入归档文件的音频字节数
+        ArchiveBytesDropped,  // 归档线程跟不上而丢弃的音频字节数
+        CounterCount
+    };
+
+    enum Histogram {
+        CaptureToEmit,      // 帧凑满 → 编码完成
+        EmitToWrite,        // 编码完成 → 写入 socket (含发送节拍等待)
+        CaptureToWrite,
+        WriteToResult,      // 最近一次写入 → 收到识别结果
+        FirstResult,        // 会话开始 → 第一条识别结果
+        FinalResult,        // 结束帧写入 → 最终结果
+        ReconnectTime,      // 连接断开 → 重放完成
+        HistogramCount
+    };
+
+    static qint64 now();
+
+    void add(Counter counter, quint64 value = 1)
+    {
+        m_counters[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+    // startNs 为 0 表示没有起点 (例如补发的静音帧)，不记录
+    void record(Histogram histogram, qint64 startNs, qint64 endNs);
+
+    quint64 counter(Counter counter) const { return m_counters[counter].load(std::memory_order_relaxed); }
+    const MetricHistogram &histogram(Histogram histogram) const { return m_histograms[histogram]; }
+
+    void reset();
+
+    // Prometheus 文本格式 / JSON 快照
+    QByteArray toPrometheus() const;
+    QByteArray toJson() const;
+    // 扩展名为 .json 时写 JSON，否则写 Prometheus 文本
+    bool writeSnapshot(const QString &path, QString *error = nullptr) const;
+
+    static const char *counterName(Counter counter);
+    static const char *histogramName(Histogram histogram);
+
+private:
+    std::atomic<quint64> m_counters[CounterCount] = {};
+    MetricHistogram m_histograms[HistogramCount];
+};
+
+#endif // PIPELINEMETRICS_H
@@ -0,0 +1,21 @@
+#include "pipelineStage.h"
+
+#include <QMetaObject>
+
+PipelineStage::PipelineStage(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void PipelineStage::wake()
+{
+    if (m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+        return;  // 已有一次处理排队等待执行
+    }
+
+    QMetaObject::invokeMethod(this, [this]() {
+        // 先清除标志再处理，处理期间到达的新数据会再次排队
+        m_wakePending.store(false, std::memory_order_release);
+        process();
+    }, Qt::QueuedConnection);
+}
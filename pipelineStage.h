@@ -0,0 +1,36 @@
+#ifndef PIPELINESTAGE_H
+#define PIPELINESTAGE_H
+
+#include <QObject>
+
+#include <atomic>
+
+class PipelineMetrics;
+
+// 流水线阶段基类：每个阶段运行在自己的线程中，
+// 上游写入数据后调用 wake()，在本阶段线程里异步执行 process()。
+// 多次 wake() 在 process() 执行前合并为一次，避免事件队列堆积。
+class PipelineStage : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PipelineStage(QObject *parent = nullptr);
+
+    // 线程安全，可在任意线程调用
+    void wake();
+
+    // 启动线程之前设置，可为空
+    void setMetrics(PipelineMetrics *metrics) { m_metrics = metrics; }
+
+protected:
+    // 在本阶段所在线程中处理所有可用输入
+    virtual void process() = 0;
+
+    PipelineMetrics *m_metrics = nullptr;
+
+private:
+    std::atomic<bool> m_wakePending{false};
+};
+
+#endif // PIPELINESTAGE_H
@@ -0,0 +1,133 @@
+#include "polyphaseResampler.h"
+#include "audioKernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace {
+constexpr int ZERO_CROSSINGS = 16;   // 原型滤波器单侧的过零点数，决定过渡带宽度
+constexpr double ROLLOFF = 0.85;     // 截止频率相对较低一侧奈奎斯特频率的比例
+constexpr double KAISER_BETA = 8.0;  // 约 80dB 阻带衰减
+
+// 第一类零阶修正贝塞尔函数，级数展开
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+}
+
+PolyphaseResampler::PolyphaseResampler()
+{
+    configure(1, 1);
+}
+
+void PolyphaseResampler::configure(int inputRate, int outputRate)
+{
+    const int divisor = std::gcd(qMax(1, inputRate), qMax(1, outputRate));
+    m_interpolation = qMax(1, outputRate) / divisor;
+    m_decimation = qMax(1, inputRate) / divisor;
+
+    if (isPassthrough()) {
+        m_interpolation = m_decimation = 1;
+        m_taps = 1;
+        m_coefficients = { 1.0f };
+    } else {
+        designFilter(inputRate, outputRate);
+    }
+    reset();
+}
+
+void PolyphaseResampler::designFilter(int inputRate, int outputRate)
+{
+    const int L = m_interpolation;
+    const int M = m_decimation;
+
+    // 降采样时抽头数随抽取倍数增加，保持过渡带相对输出采样率不变；取 4 的倍数便于向量化
+    const double ratio = qMax(1.0, double(M) / L);
+    m_taps = (int(std::ceil(2 * ZERO_CROSSINGS * ratio)) + 3) & ~3;
+    const int length = L * m_taps;
+
+    // 插值域 (采样率 L * inputRate) 中的归一化截止频率
+    const double cutoff = 0.5 * ROLLOFF * qMin(inputRate, outputRate) / (double(L) * inputRate);
+    const double center = (length - 1) / 2.0;
+    const double windowNorm = besselI0(KAISER_BETA);
+
+    QList<double> prototype(length);
+    double sum = 0.0;
+    for (int n = 0; n < length; ++n) {
+        const double t = n - center;
+        const double x = 2 * cutoff * t;
+        const double sinc = t == 0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+        const double r = t / (center + 1);
+        const double window = besselI0(KAISER_BETA * std::sqrt(qMax(0.0, 1 - r * r))) / windowNorm;
+        prototype[n] = 2 * cutoff * sinc * window;
+        sum += prototype[n];
+    }
+
+    // 插零后每个输入样本只贡献一次，直流增益需为 L
+    const double gain = L / sum;
+
+    // 第 p 组的第 j 个系数为 h[p + (taps - 1 - j) * L]，与按时间顺序排列的输入对齐
+    m_coefficients.resize(length);
+    for (int p = 0; p < L; ++p) {
+        for (int j = 0; j < m_taps; ++j) {
+            m_coefficients[p * m_taps + j] = float(prototype[p + (m_taps - 1 - j) * L] * gain);
+        }
+    }
+}
+
+void PolyphaseResampler::reset()
+{
+    // 以静音作为初始历史，第一个输出点对齐到第一个输入样本
+    m_buffer.fill(0.0f, m_taps - 1);
+    m_position = qint64(m_taps - 1) * m_interpolation;
+}
+
+void PolyphaseResampler::process(const float *input, qsizetype count, QList<float> &output)
+{
+    if (isPassthrough()) {
+        output.append(QList<float>(input, input + count));
+        return;
+    }
+
+    const qsizetype history = m_taps - 1;
+    m_buffer.resize(history + count);
+    memcpy(m_buffer.data() + history, input, count * sizeof(float));
+
+    const float *buffer = m_buffer.constData();
+    const qsizetype bufferSize = m_buffer.size();
+    // 预先按上限扩容，直接写入，最后截掉多余部分
+    const qsizetype capacity = qMax<qint64>(0, (qint64(bufferSize) * m_interpolation - m_position) / m_decimation + 1);
+    const qsizetype start = output.size();
+    output.resize(start + capacity);
+    float *out = output.data() + start;
+    qsizetype produced = 0;
+
+    for (;;) {
+        const qsizetype newest = m_position / m_interpolation;
+        if (newest >= bufferSize) {
+            break;
+        }
+        const int phase = int(m_position % m_interpolation);
+        out[produced++] = audioDotProduct(m_coefficients.constData() + phase * m_taps,
+                                          buffer + newest - history, m_taps);
+        m_position += m_decimation;
+    }
+    output.resize(start + produced);
+
+    // 只保留最后 m_taps - 1 个样本作为下次调用的历史
+    const qsizetype dropped = bufferSize - history;
+    memmove(m_buffer.data(), m_buffer.constData() + dropped, history * sizeof(float));
+    m_buffer.resize(history);
+    m_position -= qint64(dropped) * m_interpolation;
+}
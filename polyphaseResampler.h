@@ -0,0 +1,37 @@
+#ifndef POLYPHASERESAMPLER_H
+#define POLYPHASERESAMPLER_H
+
+#include <QList>
+#include <QtGlobal>
+
+// 有理数倍率的多相 FIR 重采样器 (单声道浮点)
+// 输入/输出采样率约分为 L/M：概念上先 L 倍插零再低通、最后 M 倍抽取，
+// 实际只计算被保留的输出点，每个输出点只用到 L 组子滤波器中的一组。
+// 每组系数按时间倒序存放，与输入历史连续对齐，内积可直接向量化。
+class PolyphaseResampler
+{
+public:
+    PolyphaseResampler();
+
+    // 重新设计滤波器并清空历史；两个采样率相同时为直通
+    void configure(int inputRate, int outputRate);
+    void reset();
+
+    bool isPassthrough() const { return m_interpolation == m_decimation; }
+
+    // 处理 count 个输入样本，结果追加到 output 末尾
+    void process(const float *input, qsizetype count, QList<float> &output);
+
+private:
+    void designFilter(int inputRate, int outputRate);
+
+    int m_interpolation = 1;  // L
+    int m_decimation = 1;     // M
+    int m_taps = 0;           // 每组子滤波器的抽头数
+    QList<float> m_coefficients;  // L 组，每组 m_taps 个，倒序
+
+    QList<float> m_buffer;  // 前 m_taps - 1 个为上次调用留下的历史
+    qint64 m_position = 0;  // 下一个输出点在插值域中相对 m_buffer 开头的位置
+};
+
+#endif // POLYPHASERESAMPLER_H
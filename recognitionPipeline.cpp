@@ -0,0 +1,284 @@
+#include "recognitionPipeline.h"
+#include "audioRingBuffer.h"
+#include "audioCaptureWorker.h"
+#include "audioFileSource.h"
+#include "audioPreprocessor.h"
+#include "frameEncoder.h"
+#include "iatClient.h"
+#include "audioArchiver.h"
+
+#include <QAbstractEventDispatcher>
+#include <QMetaObject>
+
+#include <utility>
+
+namespace {
+constexpr qint64 RING_BUFFER_CAPACITY = 512 * 1024;  // 采集环形缓冲区容量，约 16 秒 16k/16bit 音频
+constexpr size_t FRAME_QUEUE_CAPACITY = 64;  // 阶段间队列最多缓存的帧数，40ms 帧时约2.5秒音频
+constexpr int SHARED_FRAMES_PER_TURN = 2;  // 共用网络线程时每个会话一次最多连续发送的帧数
+}
+
+RecognitionPipeline::RecognitionPipeline(QObject *parent)
+    : QObject(parent)
+    , m_audioFrames(FRAME_QUEUE_CAPACITY)
+    , m_encodedFrames(FRAME_QUEUE_CAPACITY)
+    , m_recycledMessages(FRAME_QUEUE_CAPACITY)
+    , m_credentials(IatCredentials::fromEnvironment())
+    , m_endpoint(QString(IAT_ENDPOINT))
+{
+    for (const char *name : { "AudioCapture", "AudioPreprocess", "FrameEncoder", "IatNetwork", "AudioArchive" }) {
+        QThread *thread = new QThread;
+        thread->setObjectName(name);
+        m_ownedThreads.append(thread);
+    }
+    setupStages(m_ownedThreads[0], m_ownedThreads[1], m_ownedThreads[2], m_ownedThreads[3], m_ownedThreads[4]);
+
+    // 采集线程实时性要求最高，写盘的归档线程最低
+    m_ownedThreads[0]->start(QThread::TimeCriticalPriority);
+    for (int i = 1; i < m_ownedThreads.size() - 1; ++i) {
+        m_ownedThreads[i]->start();
+    }
+    m_ownedThreads.last()->start(QThread::LowPriority);
+}
+
+RecognitionPipeline::RecognitionPipeline(QThread *captureThread, QThread *workerThread, QThread *archiveThread,
+                                         QObject *parent)
+    : QObject(parent)
+    , m_audioFrames(FRAME_QUEUE_CAPACITY)
+    , m_encodedFrames(FRAME_QUEUE_CAPACITY)
+    , m_recycledMessages(FRAME_QUEUE_CAPACITY)
+    , m_credentials(IatCredentials::fromEnvironment())
+    , m_endpoint(QString(IAT_ENDPOINT))
+{
+    // 预处理、编码和网络阶段位于同一线程，会话内部的唤醒不再跨线程
+    setupStages(captureThread, workerThread, workerThread, workerThread, archiveThread);
+}
+
+void RecognitionPipeline::setupStages(QThread *captureThread, QThread *preprocessThread, QThread *encoderThread,
+                                      QThread *networkThread, QThread *archiveThread)
+{
+    m_capture = new AudioCaptureWorker(RING_BUFFER_CAPACITY);
+    m_ring = m_capture->ring();
+    m_preprocessor = new AudioPreprocessor(m_ring, &m_audioFrames);
+    m_encoder = new FrameEncoder(&m_audioFrames, &m_encodedFrames, &m_recycledMessages);
+    m_client = new IatClient(&m_encodedFrames, &m_recycledMessages);
+    m_archiver = new AudioArchiver;
+    if (m_ownedThreads.isEmpty()) {
+        // 网络线程由多个会话共用，限制每次连续发送的帧数，各会话轮流发送
+        m_client->setMaxFramesPerTurn(SHARED_FRAMES_PER_TURN);
+    }
+
+    // 相邻阶段互相唤醒：下游有新数据时唤醒下游，上游腾出空间时唤醒上游
+    m_preprocessor->setUpstream(m_capture);
+    m_preprocessor->setDownstream(m_encoder);
+    m_encoder->setUpstream(m_preprocessor);
+    m_encoder->setDownstream(m_client);
+    m_client->setUpstream(m_encoder);
+    m_preprocessor->setArchiver(m_archiver);
+
+    // readyRead 在采集线程发出，wake() 线程安全，直接连接即可
+    connect(m_ring, &QIODevice::readyRead, m_preprocessor, &PipelineStage::wake, Qt::DirectConnection);
+    // 服务端提前结束一段时，编码阶段在自己的线程中从第一帧重新开始
+    connect(m_client, &IatClient::segmentRestartRequested, m_encoder, &FrameEncoder::restartSegment);
+    connect(m_client, &IatClient::frameDurationChanged, m_preprocessor, &AudioPreprocessor::setFrameDuration);
+
+    // 结果经由排队连接回到调用方线程
+    connect(m_client, &IatClient::resultReceived, this, &RecognitionPipeline::resultReceived);
+    connect(m_client, &IatClient::finalResultReceived, this, &RecognitionPipeline::finalResultReceived);
+    connect(m_client, &IatClient::errorResponse, this, &RecognitionPipeline::errorResponse);
+    connect(m_client, &IatClient::sessionClosed, this, &RecognitionPipeline::sessionClosed);
+    connect(m_preprocessor, &AudioPreprocessor::monitorFinished, this, &RecognitionPipeline::microphoneTestFinished);
+    connect(m_preprocessor, &AudioPreprocessor::levelChanged, this, &RecognitionPipeline::levelChanged);
+    connect(m_preprocessor, &AudioPreprocessor::utteranceStarted, this, &RecognitionPipeline::speechStarted);
+    connect(m_preprocessor, &AudioPreprocessor::utteranceEnded, this, &RecognitionPipeline::speechEnded);
+    connect(m_archiver, &AudioArchiver::archiveFinished, this, &RecognitionPipeline::archiveFinished);
+    connect(m_capture, &AudioCaptureWorker::devicesEnumerated, this, &RecognitionPipeline::inputDevicesEnumerated);
+    connect(m_capture, &AudioCaptureWorker::initialized, this, &RecognitionPipeline::captureInitialized);
+    connect(m_capture, &AudioCaptureWorker::fileFinished, this, &RecognitionPipeline::inputFinished);
+
+    const std::pair<PipelineStage *, QThread *> stages[] = {
+        { m_capture, captureThread },
+        { m_preprocessor, preprocessThread },
+        { m_encoder, encoderThread },
+        { m_client, networkThread },
+        { m_archiver, archiveThread },
+    };
+    for (const auto &stage : stages) {
+        stage.first->setMetrics(&m_metrics);
+        stage.first->moveToThread(stage.second);
+        if (!m_ownedThreads.isEmpty()) {
+            connect(stage.second, &QThread::finished, stage.first, &QObject::deleteLater);
+        }
+    }
+}
+
+void RecognitionPipeline::initializeCapture()
+{
+    // 设备枚举和格式协商在采集线程中进行，不阻塞调用方
+    QMetaObject::invokeMethod(m_capture, &AudioCaptureWorker::initialize, Qt::QueuedConnection);
+}
+
+void RecognitionPipeline::refreshInputDevices()
+{
+    QMetaObject::invokeMethod(m_capture, &AudioCaptureWorker::enumerateDevices, Qt::QueuedConnection);
+}
+
+void RecognitionPipeline::prewarmConnections()
+{
+    const IatCredentials credentials = m_credentials;
+    const QUrl endpoint = m_endpoint;
+    QMetaObject::invokeMethod(m_client, [this, credentials, endpoint]() {
+        m_client->setCredentials(credentials);
+        m_client->setEndpoint(endpoint);
+        m_client->prewarm();
+    }, Qt::QueuedConnection);
+}
+
+RecognitionPipeline::~RecognitionPipeline()
+{
+    if (!m_ownedThreads.isEmpty()) {
+        // 自有线程：逆着数据流方向依次退出，线程结束时删除其中的阶段。
+        // 归档阶段由预处理阶段写入，最后退出，删除前写完剩余音频并补全文件头
+        for (int i = m_ownedThreads.size() - 2; i >= 0; --i) {
+            m_ownedThreads[i]->quit();
+            m_ownedThreads[i]->wait();
+        }
+        m_ownedThreads.last()->quit();
+        m_ownedThreads.last()->wait();
+        qDeleteAll(m_ownedThreads);
+        return;
+    }
+
+    // 共用线程：阶段必须在各自线程中同步删除，之后才能释放它们引用的队列。
+    // 借用线程的事件分发器作为调用上下文，避免在阶段自身的事件处理中删除它。
+    // 环形缓冲区只在采集线程发出 readyRead，先在采集线程停止采集并断开与预处理阶段的连接
+    AudioCaptureWorker *capture = m_capture;
+    AudioPreprocessor *preprocessor = m_preprocessor;
+    AudioRingBuffer *ring = m_ring;
+    QAbstractEventDispatcher *captureContext = capture->thread()->eventDispatcher();
+    QMetaObject::invokeMethod(captureContext, [capture, preprocessor, ring]() {
+        capture->reset();
+        QObject::disconnect(ring, nullptr, preprocessor, nullptr);
+    }, Qt::BlockingQueuedConnection);
+
+    // 工作线程上的三个阶段删除之后，不再有对象访问采集阶段和环形缓冲区
+    PipelineStage *const workerStages[] = { m_preprocessor, m_encoder, m_client };
+    QMetaObject::invokeMethod(m_client->thread()->eventDispatcher(), [&workerStages]() {
+        for (PipelineStage *stage : workerStages) {
+            delete stage;
+        }
+    }, Qt::BlockingQueuedConnection);
+
+    // 预处理阶段已删除，归档阶段在自己的线程中写完剩余音频后删除
+    AudioArchiver *archiver = m_archiver;
+    QMetaObject::invokeMethod(archiver->thread()->eventDispatcher(), [archiver]() {
+        delete archiver;
+    }, Qt::BlockingQueuedConnection);
+
+    QMetaObject::invokeMethod(captureContext, [capture]() {
+        delete capture;
+    }, Qt::BlockingQueuedConnection);
+}
+
+void RecognitionPipeline::setInputDevice(const QByteArray &deviceId, int channel)
+{
+    QMetaObject::invokeMethod(m_capture, [this, deviceId, channel]() {
+        m_capture->setInput(deviceId, channel);
+    }, Qt::QueuedConnection);
+}
+
+void RecognitionPipeline::resetStages(AudioPreprocessor::Mode mode, bool fileInput)
+{
+    // 按数据流方向依次复位：上游停止产出后，下游在自己的线程里清空输入
+    QMetaObject::invokeMethod(m_capture, &AudioCaptureWorker::reset, Qt::BlockingQueuedConnection);
+
+    const VoiceActivityDetector::Config vadConfig = m_vadConfig;
+    const int frameMs = m_frameMs;
+    const QString archiveDirectory = m_archiveDirectory;
+    QMetaObject::invokeMethod(m_preprocessor, [this, mode, vadConfig, frameMs, archiveDirectory]() {
+        m_preprocessor->setVoiceActivityConfig(vadConfig);
+        m_preprocessor->setArchiveDirectory(archiveDirectory);
+        m_preprocessor->reset(mode);
+        m_preprocessor->setFrameDuration(frameMs);
+    }, Qt::BlockingQueuedConnection);
+
+    if (mode == AudioPreprocessor::MonitorMode) {
+        return;
+    }
+
+    const IatCredentials credentials = m_credentials;
+    const AudioEncoding encoding = m_encoding;
+    QMetaObject::invokeMethod(m_encoder, [this, credentials, encoding]() {
+        m_encoder->setAppId(credentials.appId);
+        m_encoder->setEncoding(encoding);
+        m_encoder->reset();
+    }, Qt::BlockingQueuedConnection);
+
+    // 实时采集按音频时长节拍发送，文件输入只受 socket 发送积压限制
+    const FramePump::Pacing pacing = fileInput ? FramePump::MaxThroughputPacing
+                                               : FramePump::RealTimePacing;
+    const QUrl endpoint = m_endpoint;
+    const bool adaptive = m_adaptiveFrames;
+    const bool listening = mode == AudioPreprocessor::ListenMode;
+    // 构建时未包含的编码由编码阶段退回 raw，网络阶段按实际使用的编码处理
+    const AudioEncoding uplinkEncoding = audioEncodingSupported(encoding) ? encoding : AudioEncoding::Raw;
+    QMetaObject::invokeMethod(m_client, [this, pacing, credentials, endpoint, frameMs, adaptive, listening,
+                                         uplinkEncoding]() {
+        m_client->setCredentials(credentials);
+        m_client->setAudioEncoding(uplinkEncoding);
+        m_client->setEndpoint(endpoint);
+        m_client->setFrameDuration(frameMs, adaptive);
+        m_client->setListening(listening);
+        m_client->reset(pacing);
+    }, Qt::BlockingQueuedConnection);
+}
+
+void RecognitionPipeline::startCapture()
+{
+    resetStages(AudioPreprocessor::StreamMode, false);
+    QMetaObject::invokeMethod(m_capture, &AudioCaptureWorker::startDevice, Qt::QueuedConnection);
+}
+
+void RecognitionPipeline::startListening()
+{
+    resetStages(AudioPreprocessor::ListenMode, false);
+    QMetaObject::invokeMethod(m_capture, &AudioCaptureWorker::startDevice, Qt::QueuedConnection);
+}
+
+bool RecognitionPipeline::startFile(const QString &path, const QAudioFormat &rawFormat, bool realTime,
+                                    QString *error)
+{
+    // 只在调用方线程解析文件头，音频数据由采集线程读取
+    auto source = std::make_shared<AudioFileSource>();
+    if (!source->open(path, rawFormat, error)) {
+        return false;
+    }
+    startSource(std::move(source), realTime);
+    return true;
+}
+
+void RecognitionPipeline::startSource(std::shared_ptr<AudioFileSource> source, bool realTime)
+{
+    resetStages(AudioPreprocessor::StreamMode, !realTime);
+    QMetaObject::invokeMethod(m_capture, [this, source, realTime]() {
+        m_capture->startFile(source, realTime);
+    }, Qt::QueuedConnection);
+}
+
+void RecognitionPipeline::startData(const QByteArray &pcm, const QAudioFormat &format, bool realTime)
+{
+    auto source = std::make_shared<AudioFileSource>();
+    source->openData(pcm, format);
+    startSource(std::move(source), realTime);
+}
+
+void RecognitionPipeline::startMicrophoneTest()
+{
+    resetStages(AudioPreprocessor::MonitorMode, false);
+    QMetaObject::invokeMethod(m_capture, &AudioCaptureWorker::startDevice, Qt::QueuedConnection);
+}
+
+void RecognitionPipeline::stop()
+{
+    QMetaObject::invokeMethod(m_capture, &AudioCaptureWorker::stop, Qt::QueuedConnection);
+}
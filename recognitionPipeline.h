@@ -0,0 +1,158 @@
+#ifndef RECOGNITIONPIPELINE_H
+#define RECOGNITIONPIPELINE_H
+
+#include <QObject>
+#include <QThread>
+#include <QByteArray>
+#include <QString>
+#include <QAudioFormat>
+#include <QUrl>
+#include <QList>
+#include <QStringList>
+
+#include <memory>
+
+#include "spscQueue.h"
+#include "iatProtocol.h"
+#include "voiceActivityDetector.h"
+#include "iatCredentials.h"
+#include "pipelineMetrics.h"
+#include "audioCodec.h"
+#include "audioPreprocessor.h"
+
+class AudioRingBuffer;
+class AudioFileSource;
+class AudioCaptureWorker;
+class AudioArchiver;
+class FrameEncoder;
+class IatClient;
+
+// 识别流水线：采集 → 预处理 → 帧编码 → 网络，阶段之间通过无锁的环形缓冲区/队列传递数据。
+// 一条流水线即一个识别会话，会话状态全部在各阶段对象中。
+// 单独创建时每个阶段运行在自己的线程上；由 RecognizerEngine 创建时，
+// 采集阶段和其余三个阶段分别放到引擎共用的采集线程和工作线程上，线程数不随会话数增长。
+// 会话音频归档 (可选) 在单独的低优先级线程中写盘，磁盘慢时不影响识别。
+// 本对象位于调用方线程，只负责启动、停止和转发结果信号。
+class RecognitionPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RecognitionPipeline(QObject *parent = nullptr);
+    // 使用外部线程：captureThread 运行采集阶段，workerThread 运行预处理、编码和网络阶段，
+    // archiveThread 运行归档阶段；三个线程都必须已经启动，并且比本对象存活得更久
+    RecognitionPipeline(QThread *captureThread, QThread *workerThread, QThread *archiveThread,
+                        QObject *parent = nullptr);
+    ~RecognitionPipeline() override;
+
+    // 输入设备 (QAudioDevice::id()，为空时使用系统默认设备) 和声道 (-1 表示混音)，
+    // 在 initializeCapture()/startCapture() 之前设置
+    void setInputDevice(const QByteArray &deviceId, int channel = -1);
+
+    // 在采集线程中提前枚举设备、协商格式；只转写文件时无需调用。
+    // 完成后依次发出 inputDevicesEnumerated 和 captureInitialized
+    void initializeCapture();
+    // 在采集线程中重新枚举输入设备 (设备插拔后)，结果由 inputDevicesEnumerated 发出
+    void refreshInputDevices();
+
+    void startCapture();
+    // 常开的听音模式：持续采集，语音活动检测发现有人说话时才取连接开始一句话，
+    // 先发出语音开始前最近 paddingMs 的预录音频，语音之后静音 utteranceEndMs 即结束这句话并释放连接。
+    // 各句的结果接续在同一份文本中；stop() 之后发出 finalResultReceived 和 sessionClosed
+    void startListening();
+    // 识别音频文件：.wav 按文件头确定格式，其他文件按 rawFormat 视为裸 PCM；
+    // 文件在采集线程中逐块读取，打不开或格式不支持时返回 false。
+    // 非 16k 单声道 Int16 的音频在采集阶段转换；
+    // realTime 为 true 时按音频时长回放并按实时节拍发送，用于模拟麦克风输入
+    bool startFile(const QString &path, const QAudioFormat &rawFormat, bool realTime = false,
+                   QString *error = nullptr);
+    // 同上，使用已经打开的文件 (例如需要事先知道时长时)
+    void startSource(std::shared_ptr<AudioFileSource> source, bool realTime = false);
+    // 内存中的 PCM 数据，format 为其实际格式
+    void startData(const QByteArray &pcm, const QAudioFormat &format, bool realTime = false);
+    void startMicrophoneTest();
+
+    // 默认取自环境变量，下次开始识别时生效
+    void setCredentials(const IatCredentials &credentials) { m_credentials = credentials; }
+    IatCredentials credentials() const { return m_credentials; }
+
+    // 服务地址，默认 IAT_ENDPOINT，下次开始识别时生效
+    void setEndpoint(const QUrl &endpoint) { m_endpoint = endpoint; }
+    QUrl endpoint() const { return m_endpoint; }
+
+    // 按当前凭据和地址在网络线程中预先建立连接，开始识别时省去握手等待；
+    // 修改凭据或地址后可再次调用
+    void prewarmConnections();
+
+    // 上行音频编码，默认 raw；构建时未包含的编码退回 raw。下次开始识别时生效
+    void setAudioEncoding(AudioEncoding encoding) { m_encoding = encoding; }
+    AudioEncoding audioEncoding() const { return m_encoding; }
+
+    // 语音活动检测参数，下次开始识别时生效
+    void setVoiceActivityConfig(const VoiceActivityDetector::Config &config) { m_vadConfig = config; }
+    VoiceActivityDetector::Config voiceActivityConfig() const { return m_vadConfig; }
+
+    // 每帧音频时长 (MIN_FRAME_MS ~ MAX_FRAME_MS，默认 DEFAULT_FRAME_MS)，下次开始识别时生效。
+    // 开启自适应后以此为初始值，网络阶段在链路快时缩小帧长、发送积压或往返时延升高时加大帧长
+    void setFrameDuration(int msecs) { m_frameMs = boundFrameMs(msecs); }
+    int frameDuration() const { return m_frameMs; }
+    void setAdaptiveFrameDuration(bool adaptive) { m_adaptiveFrames = adaptive; }
+    bool adaptiveFrameDuration() const { return m_adaptiveFrames; }
+
+    // 会话音频归档目录，下次开始时生效；为空 (默认) 时不归档。
+    // 每次会话写一个 16k 单声道 WAV 文件，完成后发出 archiveFinished
+    void setArchiveDirectory(const QString &directory) { m_archiveDirectory = directory; }
+    QString archiveDirectory() const { return m_archiveDirectory; }
+
+    // 停止输入，剩余音频作为最后一帧发出
+    void stop();
+
+    // 各阶段累计的计数器和延迟直方图，可在任意线程读取
+    PipelineMetrics *metrics() { return &m_metrics; }
+
+signals:
+    void resultReceived(const RecognitionResult &result);
+    void finalResultReceived();
+    void errorResponse(int code, const QString &message);
+    void sessionClosed();
+    void microphoneTestFinished(const QByteArray &recording);
+    void archiveFinished(const QString &path, qint64 dataBytes);
+    void inputDevicesEnumerated(const QStringList &names, const QList<QByteArray> &ids);
+    void captureInitialized();
+    // 文件输入读到了末尾 (没有被 stop() 提前停止)，在本会话的 finalResultReceived 之前发出。
+    // 只有收到它的会话，最终结果才对应整个文件
+    void inputFinished();
+    void levelChanged(double rmsDb, double peakDb);
+    // 听音模式下一句话的开始和结束
+    void speechStarted();
+    void speechEnded();
+
+private:
+    void setupStages(QThread *captureThread, QThread *preprocessThread, QThread *encoderThread,
+                     QThread *networkThread, QThread *archiveThread);
+    void resetStages(AudioPreprocessor::Mode mode, bool fileInput);
+
+    QList<QThread *> m_ownedThreads;  // 单独运行时自己创建的线程，按数据流方向排列，最后是归档线程
+
+    SpscQueue<AudioFrame> m_audioFrames;
+    SpscQueue<EncodedFrame> m_encodedFrames;
+    SpscQueue<QByteArray> m_recycledMessages;  // 网络阶段发送完的消息缓冲区归还给编码阶段
+
+    PipelineMetrics m_metrics;
+    IatCredentials m_credentials;
+    QUrl m_endpoint;
+    VoiceActivityDetector::Config m_vadConfig;
+    AudioEncoding m_encoding = AudioEncoding::Raw;
+    int m_frameMs = DEFAULT_FRAME_MS;
+    bool m_adaptiveFrames = false;
+    QString m_archiveDirectory;
+
+    AudioRingBuffer *m_ring;
+    AudioCaptureWorker *m_capture;
+    AudioPreprocessor *m_preprocessor;
+    FrameEncoder *m_encoder;
+    IatClient *m_client;
+    AudioArchiver *m_archiver;
+};
+
+#endif // RECOGNITIONPIPELINE_H
@@ -0,0 +1,107 @@
+#include "recognizerEngine.h"
+#include "recognitionPipeline.h"
+
+#include <QThread>
+#include <QDebug>
+
+RecognizerEngine::RecognizerEngine(QObject *parent)
+    : RecognizerEngine(Config(), parent)
+{
+}
+
+RecognizerEngine::RecognizerEngine(const Config &config, QObject *parent)
+    : QObject(parent)
+{
+    const int workers = config.workerThreads > 0
+                            ? config.workerThreads
+                            : qBound(1, QThread::idealThreadCount(), MAX_DEFAULT_WORKERS);
+    m_captures = startThreads(qMax(1, config.captureThreads), "EngineCapture", QThread::TimeCriticalPriority);
+    m_workers = startThreads(workers, "EngineWorker", QThread::InheritPriority);
+    // 归档只是顺序写盘，一个线程足够，慢盘只会让它落后而不影响识别
+    m_archives = startThreads(1, "EngineArchive", QThread::LowPriority);
+
+    qDebug() << "Recognizer engine started with" << m_captures.size() << "capture and"
+             << m_workers.size() << "worker thread(s)";
+}
+
+RecognizerEngine::~RecognizerEngine()
+{
+    // 会话在析构时要同步删除各线程中的阶段，必须在线程退出之前完成；
+    // 删除时 destroyed 回调会修改 m_sessions，因此遍历副本
+    const QList<RecognitionPipeline *> sessions = m_sessions;
+    qDeleteAll(sessions);
+
+    for (QList<ThreadLoad> *pool : { &m_workers, &m_captures, &m_archives }) {
+        for (ThreadLoad &slot : *pool) {
+            slot.thread->quit();
+            slot.thread->wait();
+            delete slot.thread;
+        }
+    }
+}
+
+QList<RecognizerEngine::ThreadLoad> RecognizerEngine::startThreads(int count, const QString &name, int priority)
+{
+    QList<ThreadLoad> pool;
+    for (int i = 0; i < count; ++i) {
+        ThreadLoad slot;
+        slot.thread = new QThread;
+        slot.thread->setObjectName(QString("%1-%2").arg(name).arg(i));
+        slot.thread->start(QThread::Priority(priority));
+        pool.append(slot);
+    }
+    return pool;
+}
+
+RecognizerEngine::ThreadLoad *RecognizerEngine::leastLoaded(QList<ThreadLoad> &pool)
+{
+    ThreadLoad *best = &pool[0];
+    for (ThreadLoad &slot : pool) {
+        if (slot.sessions < best->sessions) {
+            best = &slot;
+        }
+    }
+    return best;
+}
+
+RecognitionPipeline *RecognizerEngine::createSession(const QByteArray &deviceId, int channel)
+{
+    ThreadLoad *capture = leastLoaded(m_captures);
+    ThreadLoad *worker = leastLoaded(m_workers);
+    ++capture->sessions;
+    ++worker->sessions;
+
+    RecognitionPipeline *session = new RecognitionPipeline(capture->thread, worker->thread, m_archives[0].thread, this);
+    session->setObjectName(QString("session-%1").arg(m_nextSessionId++));
+    if (!deviceId.isEmpty() || channel >= 0) {
+        session->setInputDevice(deviceId, channel);
+    }
+
+    m_sessions.append(session);
+    m_assignment.insert(session, { int(capture - m_captures.data()), int(worker - m_workers.data()) });
+
+    connect(session, &RecognitionPipeline::resultReceived, this, [this, session](const RecognitionResult &result) {
+        emit resultReceived(session, result);
+    });
+    connect(session, &RecognitionPipeline::finalResultReceived, this, [this, session]() {
+        emit finalResultReceived(session);
+    });
+    connect(session, &RecognitionPipeline::errorResponse, this, [this, session](int code, const QString &message) {
+        emit errorResponse(session, code, message);
+    });
+    connect(session, &RecognitionPipeline::sessionClosed, this, [this, session]() {
+        emit sessionClosed(session);
+    });
+
+    // 会话被删除时归还线程份额；此时 RecognitionPipeline 的析构已经完成
+    connect(session, &QObject::destroyed, this, [this, session]() {
+        const auto assignment = m_assignment.take(session);
+        --m_captures[assignment.first].sessions;
+        --m_workers[assignment.second].sessions;
+        m_sessions.removeOne(session);
+    });
+
+    qDebug() << "Created" << session->objectName() << "on" << capture->thread->objectName()
+             << "and" << worker->thread->objectName();
+    return session;
+}
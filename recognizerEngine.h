@@ -0,0 +1,71 @@
+#ifndef RECOGNIZERENGINE_H
+#define RECOGNIZERENGINE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "iatProtocol.h"
+
+class QThread;
+class RecognitionPipeline;
+
+// 多会话识别引擎：在少量共用线程上同时运行大量识别会话 (每个会话一条 RecognitionPipeline)
+// 采集阶段分配到最高优先级的采集线程上，预处理、编码和网络阶段一起分配到工作线程上，
+// 所有会话的音频归档共用一个低优先级的归档线程；
+// 新会话总是放到当前会话数最少的线程。同一线程上的会话通过事件队列轮流处理，
+// 每个会话一次只处理有限的数据量 (发送帧数、文件块数、队列容量均有上限)，不会独占线程。
+// 会话的结果信号同时转发为带会话指针的引擎信号，调用方可以集中处理。
+class RecognizerEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        int workerThreads = 0;   // <= 0 时取 CPU 核数，至多 MAX_DEFAULT_WORKERS
+        int captureThreads = 1;  // 设备回调和文件读取都很轻，通常一个足够
+    };
+
+    static constexpr int MAX_DEFAULT_WORKERS = 8;
+
+    explicit RecognizerEngine(QObject *parent = nullptr);
+    explicit RecognizerEngine(const Config &config, QObject *parent = nullptr);
+    // 先删除仍存在的会话，再停止线程
+    ~RecognizerEngine() override;
+
+    // 创建新会话，父对象为引擎；删除会话 (delete 或 deleteLater) 即释放其占用的线程份额。
+    // deviceId 为空时使用系统默认输入设备，channel >= 0 时只取该声道 (多路麦克风)
+    RecognitionPipeline *createSession(const QByteArray &deviceId = QByteArray(), int channel = -1);
+
+    QList<RecognitionPipeline *> sessions() const { return m_sessions; }
+    int workerThreadCount() const { return m_workers.size(); }
+    int captureThreadCount() const { return m_captures.size(); }
+
+signals:
+    void resultReceived(RecognitionPipeline *session, const RecognitionResult &result);
+    void finalResultReceived(RecognitionPipeline *session);
+    void errorResponse(RecognitionPipeline *session, int code, const QString &message);
+    void sessionClosed(RecognitionPipeline *session);
+
+private:
+    struct ThreadLoad
+    {
+        QThread *thread = nullptr;
+        int sessions = 0;
+    };
+
+    static QList<ThreadLoad> startThreads(int count, const QString &name, int priority);
+    static ThreadLoad *leastLoaded(QList<ThreadLoad> &pool);
+
+    QList<ThreadLoad> m_captures;
+    QList<ThreadLoad> m_workers;
+    QList<ThreadLoad> m_archives;
+    QList<RecognitionPipeline *> m_sessions;
+    QHash<RecognitionPipeline *, std::pair<int, int>> m_assignment;  // 会话 → (采集线程, 工作线程) 下标
+    int m_nextSessionId = 1;
+};
+
+#endif // RECOGNIZERENGINE_H
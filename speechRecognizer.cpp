@@ -0,0 +1,515 @@
+#include "speechRecognizer.h"
+#include "recognitionPipeline.h"
+#include "audioLevelMeter.h"
+#include "pipelineMetrics.h"
+#include "transcriptModel.h"
+#include "transcriptCache.h"
+#include "audioFileSource.h"
+#include "startupTiming.h"
+
+#include <QAudioFormat>
+#include <QMediaDevices>
+#include <QStandardPaths>
+#include <QUrl>
+#include <QTimer>
+#include <QDebug>
+
+namespace {
+constexpr double LEVEL_DISPLAY_RANGE_DB = 60.0;  // 音量条显示 -60dB~0dB
+constexpr int METRICS_REFRESH_MS = 1000;
+
+double normalizedLevel(double db)
+{
+    return qBound(0.0, 1.0 + db / LEVEL_DISPLAY_RANGE_DB, 1.0);
+}
+}
+
+SpeechRecognizer::SpeechRecognizer(QObject *parent)
+    : QObject(parent)
+    , m_pipeline(new RecognitionPipeline(this))
+    , m_transcript(new TranscriptModel(this))
+    , m_levelDb(AudioLevelMeter::MIN_DB)
+    , m_peakDb(AudioLevelMeter::MIN_DB)
+    , m_metricsPath(qEnvironmentVariable("SPEECH_METRICS_FILE"))
+    , m_archiveDir(qEnvironmentVariable("SPEECH_ARCHIVE_DIR"))
+{
+    connect(m_pipeline, &RecognitionPipeline::resultReceived,
+            this, &SpeechRecognizer::onResultReceived);
+    connect(m_pipeline, &RecognitionPipeline::errorResponse,
+            this, &SpeechRecognizer::onErrorResponse);
+    connect(m_pipeline, &RecognitionPipeline::finalResultReceived,
+            this, &SpeechRecognizer::onFinalResult);
+    connect(m_pipeline, &RecognitionPipeline::inputFinished, this, [this]() { m_fileComplete = true; });
+    connect(m_pipeline, &RecognitionPipeline::microphoneTestFinished,
+            this, &SpeechRecognizer::onMicrophoneTestFinished);
+    connect(m_pipeline, &RecognitionPipeline::levelChanged,
+            this, &SpeechRecognizer::onLevelChanged);
+    connect(m_pipeline, &RecognitionPipeline::sessionClosed,
+            this, &SpeechRecognizer::onSessionClosed);
+    connect(m_pipeline, &RecognitionPipeline::archiveFinished,
+            this, &SpeechRecognizer::onArchiveFinished);
+    connect(m_pipeline, &RecognitionPipeline::speechStarted, this, [this]() { setSpeaking(true); });
+    connect(m_pipeline, &RecognitionPipeline::speechEnded, this, [this]() { setSpeaking(false); });
+
+    // 指标由工作线程无锁累计，这里只定时通知界面重新读取
+    QTimer *metricsTimer = new QTimer(this);
+    connect(metricsTimer, &QTimer::timeout, this, &SpeechRecognizer::metricsChanged);
+    metricsTimer->start(METRICS_REFRESH_MS);
+
+    connect(m_pipeline, &RecognitionPipeline::inputDevicesEnumerated,
+            this, &SpeechRecognizer::onInputDevicesEnumerated);
+    connect(m_pipeline, &RecognitionPipeline::captureInitialized, this, []() {
+        StartupTiming::mark("audio input ready");
+    }, Qt::SingleShotConnection);
+
+    // 上行带宽受限时可通过 SPEECH_AUDIO_ENCODING=speex-wb/lame 压缩音频
+    const QString encodingName = qEnvironmentVariable("SPEECH_AUDIO_ENCODING");
+    AudioEncoding encoding = AudioEncoding::Raw;
+    if (!encodingName.isEmpty()) {
+        if (parseAudioEncoding(encodingName, &encoding) && audioEncodingSupported(encoding)) {
+            m_pipeline->setAudioEncoding(encoding);
+        } else {
+            qDebug() << "Ignoring unsupported SPEECH_AUDIO_ENCODING:" << encodingName;
+        }
+    }
+
+    // SPEECH_FRAME_MS=40~400 设置每帧音频时长，=adaptive 时按链路状况自动调整
+    const QString frameSetting = qEnvironmentVariable("SPEECH_FRAME_MS");
+    if (frameSetting == "adaptive") {
+        m_pipeline->setAdaptiveFrameDuration(true);
+    } else if (!frameSetting.isEmpty()) {
+        bool ok = false;
+        const int frameMs = frameSetting.toInt(&ok);
+        if (ok) {
+            m_pipeline->setFrameDuration(frameMs);
+        } else {
+            qDebug() << "Ignoring invalid SPEECH_FRAME_MS:" << frameSetting;
+        }
+    }
+
+    m_pipeline->setArchiveDirectory(m_archiveDir);
+
+    // 设备枚举、QAudioSource 的创建和服务连接都推迟到 warmUp()，构造时不做任何阻塞操作
+    StartupTiming::mark("recognizer created");
+}
+
+SpeechRecognizer::~SpeechRecognizer() = default;
+
+void SpeechRecognizer::warmUp()
+{
+    if (m_warmedUp) {
+        return;
+    }
+    m_warmedUp = true;
+
+    // 设备枚举和格式协商在采集线程中进行，结果经由 inputDevicesEnumerated 回到界面
+    m_pipeline->initializeCapture();
+    m_pipeline->prewarmConnections();
+
+    // 设备插拔时同样在采集线程中重新枚举
+    QMediaDevices *mediaDevices = new QMediaDevices(this);
+    connect(mediaDevices, &QMediaDevices::audioInputsChanged, m_pipeline, &RecognitionPipeline::refreshInputDevices);
+
+    QString cacheDir = qEnvironmentVariable("SPEECH_CACHE_DIR");
+    if (cacheDir.isEmpty()) {
+        cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/transcripts";
+    }
+    m_cache = std::make_unique<TranscriptCache>(cacheDir);
+    QString cacheError;
+    if (!m_cache->open(&cacheError)) {
+        qDebug() << "Transcript cache disabled:" << cacheError;
+        m_cache.reset();
+    }
+    StartupTiming::mark("warm-up requested");
+}
+
+void SpeechRecognizer::onInputDevicesEnumerated(const QStringList &names, const QList<QByteArray> &ids)
+{
+    // 按设备 id 保持当前选择，设备顺序变化时下标随之调整
+    const QByteArray selected = m_deviceIds.value(m_inputDevice);
+    m_deviceNames = QStringList{ "系统默认设备" };
+    m_deviceNames.append(names);
+    m_deviceIds = { QByteArray() };
+    m_deviceIds.append(ids);
+    m_devicesEnumerated = true;
+    emit inputDevicesChanged();
+
+    const int index = qMax(0, int(m_deviceIds.indexOf(selected)));
+    if (index != m_inputDevice) {
+        m_inputDevice = index;
+        emit inputDeviceChanged();
+    }
+}
+
+bool SpeechRecognizer::checkInputDevice() const
+{
+    // 按采集线程枚举的列表检查所选设备，不在界面线程访问多媒体后端；
+    // 尚未枚举完时交给采集线程按所选设备打开
+    if (m_devicesEnumerated && m_deviceIds.size() <= 1) {
+        qDebug() << "No audio input device found!";
+        return false;
+    }
+    qDebug() << "Using audio device:" << m_deviceNames.value(m_inputDevice);
+    return true;
+}
+
+void SpeechRecognizer::setInputDevice(int index)
+{
+    if (index == m_inputDevice || index < 0 || index >= m_deviceIds.size()) {
+        return;
+    }
+    m_inputDevice = index;
+    m_pipeline->setInputDevice(m_deviceIds[index]);
+    m_pipeline->initializeCapture();
+    emit inputDeviceChanged();
+}
+
+QString SpeechRecognizer::text() const
+{
+    return m_transcript->text();
+}
+
+double SpeechRecognizer::level() const
+{
+    return normalizedLevel(m_levelDb);
+}
+
+double SpeechRecognizer::peakLevel() const
+{
+    return normalizedLevel(m_peakDb);
+}
+
+double SpeechRecognizer::captureToSendP50() const
+{
+    return m_pipeline->metrics()->histogram(PipelineMetrics::CaptureToWrite).quantile(0.50);
+}
+
+double SpeechRecognizer::captureToSendP95() const
+{
+    return m_pipeline->metrics()->histogram(PipelineMetrics::CaptureToWrite).quantile(0.95);
+}
+
+double SpeechRecognizer::sendToResultP50() const
+{
+    return m_pipeline->metrics()->histogram(PipelineMetrics::WriteToResult).quantile(0.50);
+}
+
+double SpeechRecognizer::firstResultP50() const
+{
+    return m_pipeline->metrics()->histogram(PipelineMetrics::FirstResult).quantile(0.50);
+}
+
+qint64 SpeechRecognizer::framesSent() const
+{
+    return qint64(m_pipeline->metrics()->counter(PipelineMetrics::FramesSent));
+}
+
+qint64 SpeechRecognizer::framesSilent() const
+{
+    return qint64(m_pipeline->metrics()->counter(PipelineMetrics::FramesSilent));
+}
+
+qint64 SpeechRecognizer::bytesUploaded() const
+{
+    return qint64(m_pipeline->metrics()->counter(PipelineMetrics::BytesUploaded));
+}
+
+qint64 SpeechRecognizer::serverErrors() const
+{
+    return qint64(m_pipeline->metrics()->counter(PipelineMetrics::ServerErrors));
+}
+
+bool SpeechRecognizer::exportMetrics(const QString &path)
+{
+    QString error;
+    if (!m_pipeline->metrics()->writeSnapshot(path, &error)) {
+        qDebug() << "Failed to write metrics to" << path << ":" << error;
+        return false;
+    }
+    return true;
+}
+
+void SpeechRecognizer::setRecording(bool recording)
+{
+    if (m_recording == recording) {
+        return;
+    }
+    m_recording = recording;
+    emit recordingChanged();
+}
+
+void SpeechRecognizer::setSpeaking(bool speaking)
+{
+    if (m_speaking == speaking) {
+        return;
+    }
+    m_speaking = speaking;
+    emit speakingChanged();
+}
+
+void SpeechRecognizer::startRecording()
+{
+    if (m_recording || m_listening) return;
+
+    qDebug() << "Starting recording...";
+
+    if (!checkInputDevice()) {
+        return;
+    }
+
+    // 重置所有状态
+    ++m_session;
+    m_servedFromCache = false;
+    m_transcript->clear();
+    emit textChanged();
+
+    setRecording(true);
+    m_pipeline->startCapture();
+}
+
+void SpeechRecognizer::stopRecording()
+{
+    if (!m_recording || m_micTesting) {
+        return;  // 防止重复调用
+    }
+
+    qDebug() << "Stopping recording...";
+    setRecording(false);
+
+    // 停止输入后，剩余音频和结束帧由流水线发出
+    m_pipeline->stop();
+}
+
+void SpeechRecognizer::startListening()
+{
+    if (m_recording || m_listening) {
+        return;
+    }
+
+    if (!checkInputDevice()) {
+        return;
+    }
+
+    qDebug() << "Starting listening mode...";
+    ++m_session;
+    m_servedFromCache = false;
+    m_transcript->clear();
+    emit textChanged();
+
+    m_listening = true;
+    emit listeningChanged();
+    m_pipeline->startListening();
+}
+
+void SpeechRecognizer::stopListening()
+{
+    if (!m_listening) {
+        return;
+    }
+
+    qDebug() << "Stopping listening mode...";
+    m_listening = false;
+    emit listeningChanged();
+    setSpeaking(false);
+
+    // 正在说的话照常发完，没有人说话时直接结束
+    m_pipeline->stop();
+}
+
+void SpeechRecognizer::transcribeFile(const QString &path, int pcmSampleRate)
+{
+    if (m_recording || m_listening) {
+        qDebug() << "Already recording, ignoring request";
+        return;
+    }
+
+    // QML 的文件对话框给出的是 file:// URL
+    const QUrl url(path);
+    const QString filePath = url.isLocalFile() ? url.toLocalFile() : path;
+
+    QAudioFormat rawFormat;
+    rawFormat.setSampleRate(pcmSampleRate);
+    rawFormat.setChannelCount(1);
+    rawFormat.setSampleFormat(QAudioFormat::Int16);
+
+    // 重置状态
+    m_transcript->clear();
+    emit textChanged();
+
+    auto source = std::make_shared<AudioFileSource>();
+    QString error;
+    if (!source->open(filePath, rawFormat, &error)) {
+        qDebug() << "Failed to open audio file at:" << filePath;
+        qDebug() << "Error:" << error;
+        return;
+    }
+
+    m_cacheKey.clear();
+    m_fileComplete = false;
+    m_servedFromCache = false;
+    const quint64 session = ++m_session;
+    if (m_cache && source->size() <= TranscriptCache::SYNC_KEY_MAX_BYTES) {
+        m_cacheKey = TranscriptCache::key(*source, m_pipeline->audioEncoding(), m_pipeline->endpoint());
+        QString cached;
+        if (m_cache->lookup(m_cacheKey, &cached)) {
+            qDebug() << "Transcript cache hit for" << filePath;
+            showCachedTranscript(cached);
+            m_cacheKey.clear();
+            return;
+        }
+    } else if (m_cache) {
+        // 长录音不等整个文件读完：键在线程池中计算，同时照常开始发送
+        TranscriptCache::keyAsync(filePath, rawFormat, m_pipeline->audioEncoding(), m_pipeline->endpoint())
+            .then(this, [this, session](const QByteArray &key) { onFileKeyReady(session, key); });
+    }
+
+    // 非 16k 单声道的音频由流水线转换
+    setRecording(true);
+    m_pipeline->startSource(std::move(source));
+}
+
+void SpeechRecognizer::testPcmFile(int sampleRate)
+{
+    transcribeFile(QString("%1/iat_pcm_%2k.pcm").arg(SPEECH_SOURCE_DIR).arg(sampleRate / 1000), sampleRate);
+}
+
+void SpeechRecognizer::testMicrophone()
+{
+    if (m_recording || m_listening) {
+        qDebug() << "Already recording, ignoring request";
+        return;
+    }
+
+    if (!checkInputDevice()) {
+        return;
+    }
+
+    // 设置测试状态
+    ++m_session;
+    m_micTesting = true;
+    setRecording(true);
+
+    // 开始录音，电平分析在预处理线程中进行；测试录音总是归档，边录边由归档线程写盘
+    qDebug() << "Starting microphone test...";
+    const QString testDir = m_archiveDir.isEmpty()
+                                ? QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                                      + "/microphone-test"
+                                : m_archiveDir;
+    m_pipeline->setArchiveDirectory(testDir);
+    m_pipeline->startMicrophoneTest();
+    m_pipeline->setArchiveDirectory(m_archiveDir);
+
+    // 5秒后停止测试
+    QTimer::singleShot(5000, this, [this]() {
+        m_pipeline->stop();
+    });
+}
+
+void SpeechRecognizer::showCachedTranscript(const QString &text)
+{
+    RecognitionResult result;
+    result.sn = 1;
+    result.last = true;
+    result.text = text;
+    m_transcript->clear();
+    m_transcript->applyResult(result);
+    emit textChanged();
+}
+
+void SpeechRecognizer::onFileKeyReady(quint64 session, const QByteArray &key)
+{
+    // 会话已经结束或换成了别的识别时，键没有用处
+    if (session != m_session || !m_recording || key.isEmpty() || !m_cache) {
+        return;
+    }
+    QString cached;
+    if (!m_cache->lookup(key, &cached)) {
+        m_cacheKey = key;
+        return;
+    }
+
+    // 已经发出的部分作废：停止上传，正在结束的会话的结果不再显示
+    qDebug() << "Transcript cache hit, stopping the upload";
+    m_servedFromCache = true;
+    showCachedTranscript(cached);
+    stopRecording();
+}
+
+void SpeechRecognizer::onResultReceived(const RecognitionResult &result)
+{
+    if (m_servedFromCache) {
+        return;
+    }
+    m_transcript->applyResult(result);
+    emit textChanged();
+}
+
+void SpeechRecognizer::onFinalResult()
+{
+    // 只缓存整个文件都已送入并完整收到最终结果的识别，出错或中途停止的会话不写入
+    if (m_cache && !m_cacheKey.isEmpty() && m_fileComplete) {
+        m_cache->insert(m_cacheKey, m_transcript->text());
+        m_cacheKey.clear();
+    }
+    stopRecording();
+}
+
+void SpeechRecognizer::onErrorResponse(int code, const QString &message)
+{
+    qDebug() << "Recognition failed, code:" << code << "message:" << message;
+    m_cacheKey.clear();
+    stopRecording();
+}
+
+void SpeechRecognizer::onLevelChanged(double rmsDb, double peakDb)
+{
+    m_levelDb = rmsDb;
+    m_peakDb = peakDb;
+    emit levelChanged();
+}
+
+void SpeechRecognizer::onMicrophoneTestFinished(const QByteArray &recording)
+{
+    // 测试音频已由归档线程写入文件，这里只输出摘要
+    qDebug() << "Test recording summary:"
+             << "\nTotal duration: 5 seconds"
+             << "\nTotal samples:" << recording.size() / 2
+             << "\nSize:" << recording.size() << "bytes";
+
+    // 重置状态
+    m_micTesting = false;
+    setRecording(false);
+
+    qDebug() << "Microphone test completed";
+}
+
+void SpeechRecognizer::onArchiveFinished(const QString &path, qint64 dataBytes)
+{
+    qDebug() << "Session audio saved to:" << path << "(" << dataBytes << "bytes)";
+}
+
+void SpeechRecognizer::onSessionClosed()
+{
+    m_cacheKey.clear();
+    emit metricsChanged();
+    if (!m_metricsPath.isEmpty()) {
+        exportMetrics(m_metricsPath);
+    }
+
+    if (m_listening) {
+        // 听音期间会话意外结束 (如服务端返回错误)：重新开始听。
+        // 新会话的结果序号从头开始，旧文本无法与之拼接，一并清空
+        qDebug() << "Listening session closed unexpectedly, restarting";
+        setSpeaking(false);
+        m_transcript->clear();
+        emit textChanged();
+        m_pipeline->startListening();
+        return;
+    }
+
+    // 会话没有收到最终结果就结束 (如等待超时或连接中断) 时同样回到空闲状态，
+    // 否则文件识别会一直停在“识别中”
+    if (!m_micTesting) {
+        setRecording(false);
+    }
+}
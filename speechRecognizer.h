@@ -0,0 +1,161 @@
+#ifndef SPEECHRECOGNIZER_H
+#define SPEECHRECOGNIZER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QStringList>
+
+#include <QtQml/qqmlregistration.h>
+
+#include <memory>
+
+#include "transcriptModel.h"
+
+class RecognitionPipeline;
+class TranscriptCache;
+struct RecognitionResult;
+
+// 供 QML 使用的语音识别接口
+// 采集、编码和网络收发都在 RecognitionPipeline 的工作线程中完成，
+// 本对象只维护界面状态，并通过排队信号接收识别结果。
+// 构造时不访问音频设备和网络，界面显示之后调用 warmUp() 再在后台准备设备和连接。
+class SpeechRecognizer : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    // 完整文本，每条结果都重新拼接；界面应绑定按分段更新的 transcript 模型
+    Q_PROPERTY(QString text READ text NOTIFY textChanged)
+    Q_PROPERTY(TranscriptModel *transcript READ transcript CONSTANT)
+    Q_PROPERTY(bool recording READ recording NOTIFY recordingChanged)
+    // 听音模式：listening 为是否在听，speaking 为当前是否有人在说话 (正在发送这句话)
+    Q_PROPERTY(bool listening READ listening NOTIFY listeningChanged)
+    Q_PROPERTY(bool speaking READ speaking NOTIFY speakingChanged)
+    // 可选的输入设备，第一项为系统默认设备；inputDevice 为当前选择的下标。
+    // 设备列表在 warmUp() 之后由采集线程枚举，此前只有默认设备一项
+    Q_PROPERTY(QStringList inputDevices READ inputDevices NOTIFY inputDevicesChanged)
+    Q_PROPERTY(int inputDevice READ inputDevice WRITE setInputDevice NOTIFY inputDeviceChanged)
+    // 输入电平：level/peakLevel 为 0~1 (对应 -60dB~0dB)，供音量条直接绑定
+    Q_PROPERTY(double level READ level NOTIFY levelChanged)
+    Q_PROPERTY(double peakLevel READ peakLevel NOTIFY levelChanged)
+    Q_PROPERTY(double levelDb READ levelDb NOTIFY levelChanged)
+    // 性能指标，每秒刷新一次，供 QML 指标面板绑定
+    Q_PROPERTY(double captureToSendP50 READ captureToSendP50 NOTIFY metricsChanged)
+    Q_PROPERTY(double captureToSendP95 READ captureToSendP95 NOTIFY metricsChanged)
+    Q_PROPERTY(double sendToResultP50 READ sendToResultP50 NOTIFY metricsChanged)
+    Q_PROPERTY(double firstResultP50 READ firstResultP50 NOTIFY metricsChanged)
+    Q_PROPERTY(qint64 framesSent READ framesSent NOTIFY metricsChanged)
+    Q_PROPERTY(qint64 framesSilent READ framesSilent NOTIFY metricsChanged)
+    Q_PROPERTY(qint64 bytesUploaded READ bytesUploaded NOTIFY metricsChanged)
+    Q_PROPERTY(qint64 serverErrors READ serverErrors NOTIFY metricsChanged)
+
+public:
+    explicit SpeechRecognizer(QObject *parent = nullptr);
+    ~SpeechRecognizer() override;
+
+    QString text() const;
+    TranscriptModel *transcript() const { return m_transcript; }
+    bool recording() const { return m_recording; }
+    bool listening() const { return m_listening; }
+    bool speaking() const { return m_speaking; }
+    QStringList inputDevices() const { return m_deviceNames; }
+    int inputDevice() const { return m_inputDevice; }
+    void setInputDevice(int index);
+    double level() const;
+    double peakLevel() const;
+    double levelDb() const { return m_levelDb; }
+
+    double captureToSendP50() const;
+    double captureToSendP95() const;
+    double sendToResultP50() const;
+    double firstResultP50() const;
+    qint64 framesSent() const;
+    qint64 framesSilent() const;
+    qint64 bytesUploaded() const;
+    qint64 serverErrors() const;
+
+    // 导出指标快照：扩展名为 .json 时写 JSON，否则写 Prometheus 文本格式
+    Q_INVOKABLE bool exportMetrics(const QString &path);
+
+    // 在采集线程中枚举设备、创建 QAudioSource，预先建立服务连接并打开结果缓存；只有第一次调用生效。
+    // 没有调用就开始录音时，设备在开始录音时初始化
+    Q_INVOKABLE void warmUp();
+
+public slots:
+    void startRecording();
+    void stopRecording();
+    // 常开的听音模式：有人说话时才连接服务并上传，说完即释放连接，适合自助终端等长时间待命的场景
+    void startListening();
+    void stopListening();
+    // 识别任意路径 (或 file:// URL) 的音频文件：.wav 按文件头确定格式，
+    // 其他文件视为 pcmSampleRate 采样率的 16bit 单声道 PCM；文件边读边发，不整体读入内存。
+    // 识别过的同一段音频直接从本地缓存返回结果：短文件先查缓存，命中时不连接服务；
+    // 长录音立即开始发送，缓存键在后台计算，命中时停止上传改用缓存的结果
+    void transcribeFile(const QString &path, int pcmSampleRate = 16000);
+    // 识别自带的测试录音 iat_pcm_16k.pcm / iat_pcm_8k.pcm (16bit 单声道)
+    void testPcmFile(int sampleRate = 16000);
+    // 录 5 秒测试音频并输出电平分析，录音归档到 archiveDirectory (未设置时为应用数据目录下的 microphone-test)
+    void testMicrophone();
+
+signals:
+    void textChanged();
+    void recordingChanged();
+    void listeningChanged();
+    void speakingChanged();
+    void inputDevicesChanged();
+    void inputDeviceChanged();
+    void levelChanged();
+    void metricsChanged();
+
+private slots:
+    void onResultReceived(const RecognitionResult &result);
+    void onErrorResponse(int code, const QString &message);
+    void onMicrophoneTestFinished(const QByteArray &recording);
+    void onLevelChanged(double rmsDb, double peakDb);
+    void onSessionClosed();
+    void onArchiveFinished(const QString &path, qint64 dataBytes);
+    void onInputDevicesEnumerated(const QStringList &names, const QList<QByteArray> &ids);
+    void onFinalResult();
+
+private:
+    void setRecording(bool recording);
+    void setSpeaking(bool speaking);
+    // 按已枚举的设备列表检查能否开始采集，列表尚未收到时视为可以
+    bool checkInputDevice() const;
+    void showCachedTranscript(const QString &text);
+    void onFileKeyReady(quint64 session, const QByteArray &key);
+
+    RecognitionPipeline *m_pipeline;
+    TranscriptModel *m_transcript;
+    bool m_recording = false;
+    bool m_listening = false;
+    bool m_speaking = false;
+    QStringList m_deviceNames{ "系统默认设备" };
+    QList<QByteArray> m_deviceIds{ QByteArray() };  // 与 inputDevices 对应，默认设备为空
+    int m_inputDevice = 0;
+    bool m_devicesEnumerated = false;  // 已收到采集线程枚举的设备列表
+    bool m_micTesting = false;
+    bool m_warmedUp = false;
+    double m_levelDb;
+    double m_peakDb;
+    QString m_metricsPath;  // 环境变量 SPEECH_METRICS_FILE，每次会话结束时写入快照
+    QString m_archiveDir;   // 环境变量 SPEECH_ARCHIVE_DIR，设置后每次会话的音频都归档到该目录
+    // 文件识别结果缓存，目录为环境变量 SPEECH_CACHE_DIR，默认在系统缓存目录下；warmUp() 之前和打开失败时为空
+    std::unique_ptr<TranscriptCache> m_cache;
+    QByteArray m_cacheKey;  // 正在识别的文件的缓存键，收到最终结果时写入缓存
+    bool m_fileComplete = false;  // 文件已读到末尾，没有被 stopRecording() 提前停止
+    bool m_servedFromCache = false;  // 后台计算的键命中缓存，正在结束的会话的结果不再显示
+    quint64 m_session = 0;  // 每次开始识别时递增，丢弃属于之前会话的后台计算结果
+};
+
+// TranscriptModel 属于不依赖 QML 的 speech_core，在这里向 QML 声明其类型，
+// 使预编译的绑定可以直接访问 transcript 属性
+struct TranscriptModelForeign
+{
+    Q_GADGET
+    QML_FOREIGN(TranscriptModel)
+    QML_ANONYMOUS
+};
+
+#endif // SPEECHRECOGNIZER_H
@@ -0,0 +1,88 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 固定容量的单生产者/单消费者无锁队列，用于流水线相邻阶段之间传递帧
+// push() 只能在生产线程调用，pop()/peek() 只能在消费线程调用。
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+        : m_capacity(capacity + 1)  // 预留一个空槽区分队满与队空
+        , m_slots(new T[capacity + 1])
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    size_t capacity() const { return m_capacity - 1; }
+
+    // 队列已满时返回 false，value 保持不变
+    bool push(T &&value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t next = (head + 1) % m_capacity;
+        if (next == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_slots[head] = std::move(value);
+        m_head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(m_slots[tail]);
+        m_slots[tail] = T();
+        m_tail.store((tail + 1) % m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    // 消费端查看第 index 个待出队元素，不出队；越界时返回 nullptr
+    const T *peek(size_t index = 0) const
+    {
+        if (index >= size()) {
+            return nullptr;
+        }
+        return &m_slots[(m_tail.load(std::memory_order_relaxed) + index) % m_capacity];
+    }
+
+    size_t size() const
+    {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        return (head + m_capacity - tail) % m_capacity;
+    }
+
+    size_t freeSlots() const { return capacity() - size(); }
+    bool isEmpty() const { return size() == 0; }
+    bool isFull() const { return freeSlots() == 0; }
+
+    // 消费端清空队列
+    void clear()
+    {
+        T value;
+        while (pop(value)) {
+        }
+    }
+
+private:
+    const size_t m_capacity;
+    std::unique_ptr<T[]> m_slots;
+
+    // 读写位置分别由两个线程修改，分开放在不同缓存行避免伪共享
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+#endif // SPSCQUEUE_H
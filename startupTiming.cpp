@@ -0,0 +1,27 @@
+#include "startupTiming.h"
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+QElapsedTimer s_timer;
+qint64 s_lastMs = 0;
+}
+
+void StartupTiming::start()
+{
+    if (qEnvironmentVariableIntValue("SPEECH_STARTUP_TIMING") != 0) {
+        s_timer.start();
+    }
+}
+
+void StartupTiming::mark(const char *phase)
+{
+    // 只在 GUI 线程调用，不需要加锁
+    if (!s_timer.isValid()) {
+        return;
+    }
+    const qint64 elapsedMs = s_timer.elapsed();
+    qDebug().nospace() << "Startup: " << phase << " at " << elapsedMs << " ms (+" << elapsedMs - s_lastMs << " ms)";
+    s_lastMs = elapsedMs;
+}
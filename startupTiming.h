@@ -0,0 +1,12 @@
+#ifndef STARTUPTIMING_H
+#define STARTUPTIMING_H
+
+// 冷启动各阶段的耗时，设置环境变量 SPEECH_STARTUP_TIMING=1 时输出，
+// 每个阶段打印从进程进入 main() 起的累计时间和与上一阶段的间隔。
+namespace StartupTiming {
+// 在 main() 开头调用，之前的 mark() 不输出
+void start();
+void mark(const char *phase);
+}
+
+#endif // STARTUPTIMING_H
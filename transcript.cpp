@@ -0,0 +1,128 @@
+#include "transcript.h"
+
+#include <QStringView>
+
+namespace {
+constexpr qsizetype MAX_OVERLAP_CHARS = 6;  // 一帧重叠音频最多对应的字数
+constexpr qsizetype MIN_OVERLAP_CHARS = 2;  // 单个字相同多半是正常的重复用字，不当作重叠
+}
+
+Transcript::Edit Transcript::plan(const RecognitionResult &result) const
+{
+    Edit edit;
+    edit.stableBefore = m_stableCount;
+
+    if (result.replace) {
+        // 分段按序号递增排列，与 rg 范围重叠的分段是连续的一段
+        const int first = result.replaceFirst;
+        const int last = result.replaceLast;
+        int row = 0;
+        while (row < size() && m_segments[row].lastSn < first) {
+            ++row;
+        }
+        int end = row;
+        while (end < size() && m_segments[end].firstSn <= last) {
+            ++end;
+        }
+        edit.row = row;
+        edit.removed = end - row;
+        edit.stableAfter = qMin(m_stableCount, row);
+    } else {
+        // 追加：之前的分段全部稳定
+        edit.row = size();
+        edit.stableAfter = size();
+    }
+
+    edit.inserted = result.text.size() > overlapLength(result, edit.row) ? 1 : 0;
+
+    if (result.last) {
+        edit.stableAfter = size() - edit.removed + edit.inserted;
+    }
+    return edit;
+}
+
+Transcript::Edit Transcript::apply(const RecognitionResult &result)
+{
+    const Edit edit = plan(result);
+
+    int firstSn = result.sn;
+    if (result.replace) {
+        firstSn = qMin(firstSn, result.replaceFirst);
+        if (edit.removed > 0) {
+            firstSn = qMin(firstSn, m_segments[edit.row].firstSn);
+        }
+    }
+
+    m_segments.remove(edit.row, edit.removed);
+    if (edit.inserted > 0) {
+        Segment segment;
+        segment.firstSn = firstSn;
+        segment.lastSn = result.sn;
+        segment.text = result.text.mid(overlapLength(result, edit.row));
+        m_segments.insert(edit.row, segment);
+    }
+    m_stableCount = edit.stableAfter;
+    return edit;
+}
+
+void Transcript::clear()
+{
+    m_segments.clear();
+    m_stableCount = 0;
+}
+
+QString Transcript::text() const
+{
+    return join(0, size());
+}
+
+QString Transcript::stableText() const
+{
+    return join(0, m_stableCount);
+}
+
+QString Transcript::unstableText() const
+{
+    return join(m_stableCount, size());
+}
+
+QString Transcript::join(int first, int last) const
+{
+    qsizetype length = 0;
+    for (int i = first; i < last; ++i) {
+        length += m_segments[i].text.size();
+    }
+
+    QString text;
+    text.reserve(length);
+    for (int i = first; i < last; ++i) {
+        text += m_segments[i].text;
+    }
+    return text;
+}
+
+qsizetype Transcript::overlapLength(const RecognitionResult &result, int row) const
+{
+    // 只处理以重叠帧开头的分段中的第一个结果分段
+    if (!result.overlapsPrevious || row == 0
+        || m_segments[row - 1].lastSn / SEGMENT_SN_STRIDE == result.sn / SEGMENT_SN_STRIDE) {
+        return 0;
+    }
+    // 第一个词从重复发送的音频之后才开始时，开头的文字不可能是重叠部分
+    if (result.beginMs < 0 || result.beginMs >= SEGMENT_OVERLAP_MS) {
+        return 0;
+    }
+
+    // 上一段结尾的标点不参与比较，取能与其末尾对上的最长开头
+    QStringView tail(m_segments[row - 1].text);
+    while (!tail.isEmpty() && tail.back().isPunct()) {
+        tail.chop(1);
+    }
+    const QStringView text(result.text);
+    for (qsizetype length = qMin(MAX_OVERLAP_CHARS, qMin(tail.size(), text.size())); length >= MIN_OVERLAP_CHARS; --length) {
+        if (tail.endsWith(text.left(length))) {
+            return length;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef TRANSCRIPT_H
+#define TRANSCRIPT_H
+
+#include <QList>
+#include <QString>
+
+#include "iatProtocol.h"
+
+// 按结果序号 (sn) 分段保存的识别文本，按 wpgs 规则原地应用替换
+// 每个 apd 结果开始一个新分段，rpl 结果把 rg 范围覆盖的分段合并替换为一段。
+// 收到新的 apd 结果后，之前的分段不会再被替换，视为稳定；最后一条结果到达后全部稳定。
+// 稳定的分段总是位于开头，因此只记录稳定分段的数量。
+// 长音频分段强制切分时，新一段开头与上一段结尾重复识别的文字在拼接处去掉。
+class Transcript
+{
+public:
+    struct Segment
+    {
+        int firstSn = 0;  // 本段覆盖的结果序号范围
+        int lastSn = 0;
+        QString text;
+    };
+
+    // 一次结果对分段列表的修改：[row, row + removed) 被替换为 inserted 个新分段 (0 或 1)，
+    // 稳定分段数从 stableBefore 变为 stableAfter
+    struct Edit
+    {
+        int row = 0;
+        int removed = 0;
+        int inserted = 0;
+        int stableBefore = 0;
+        int stableAfter = 0;
+    };
+
+    // 只计算修改范围，不改变内容；供列表模型先发出 begin* 通知
+    Edit plan(const RecognitionResult &result) const;
+    Edit apply(const RecognitionResult &result);
+    void clear();
+
+    int size() const { return int(m_segments.size()); }
+    bool isEmpty() const { return m_segments.isEmpty(); }
+    const Segment &segment(int row) const { return m_segments[row]; }
+    int stableCount() const { return m_stableCount; }
+    bool isStable(int row) const { return row < m_stableCount; }
+
+    QString text() const;
+    QString stableText() const;
+    QString unstableText() const;
+
+private:
+    QString join(int first, int last) const;
+    // result 放在 row 处时开头与上一段重复的字符数
+    qsizetype overlapLength(const RecognitionResult &result, int row) const;
+
+    QList<Segment> m_segments;
+    int m_stableCount = 0;
+};
+
+#endif // TRANSCRIPT_H
@@ -0,0 +1,307 @@
+#include "transcriptCache.h"
+#include "audioFileSource.h"
+#include "iatFrameWriter.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QPromise>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QUrl>
+#include <QtEndian>
+#include <QDebug>
+
+#include <cstring>
+#include <memory>
+
+namespace {
+constexpr quint32 INDEX_MAGIC = 0x43545053;  // "SPTC"
+constexpr quint32 INDEX_VERSION = 2;  // 2: 键加入上行编码和服务地址
+const char STORE_DIRECTORY[] = "transcript-cache";
+const char ENTRY_SUFFIX[] = ".transcript";
+constexpr int BUCKET_COUNT = 1024;
+constexpr int BUCKET_WAYS = 8;
+constexpr int SLOT_COUNT = BUCKET_COUNT * BUCKET_WAYS;
+constexpr int KEY_BYTES = 20;  // SHA-1
+constexpr qint64 HASH_CHUNK_BYTES = 1024 * 1024;  // 未映射的文件按块读取计算摘要
+
+quint32 bucketOf(const char *key)
+{
+    return qFromUnaligned<quint32>(key) % BUCKET_COUNT;
+}
+
+// 条目文件名为键的小写十六进制加扩展名，其余文件都不属于缓存
+bool isEntryName(const QString &name)
+{
+    const int hexLength = KEY_BYTES * 2;
+    if (name.size() != hexLength + int(strlen(ENTRY_SUFFIX)) || !name.endsWith(QString::fromLatin1(ENTRY_SUFFIX))) {
+        return false;
+    }
+    for (int i = 0; i < hexLength; ++i) {
+        const char16_t c = name.at(i).unicode();
+        if (!((c >= u'0' && c <= u'9') || (c >= u'a' && c <= u'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+// 索引文件按本机字节序存储，只供本机使用
+struct TranscriptCache::Header
+{
+    quint32 magic;
+    quint32 version;
+    quint32 bucketCount;
+    quint32 bucketWays;
+    quint64 totalBytes;  // 全部条目的文本字节数
+    quint64 useCounter;  // 单调递增的使用序号，从 1 开始
+};
+
+struct TranscriptCache::Slot
+{
+    uchar key[KEY_BYTES];
+    quint32 textBytes;
+    quint64 lastUse;  // 最近一次命中或写入时的使用序号，0 表示空槽位
+};
+
+TranscriptCache::TranscriptCache(const QString &directory, qint64 maxBytes)
+    : m_directory(directory)
+    , m_storeDirectory(QDir(directory).filePath(STORE_DIRECTORY))
+    , m_maxBytes(maxBytes)
+{
+}
+
+TranscriptCache::~TranscriptCache()
+{
+    if (m_map) {
+        m_indexFile.unmap(m_map);
+    }
+    m_indexFile.close();
+}
+
+bool TranscriptCache::open(QString *error)
+{
+    auto fail = [error](const QString &reason) {
+        if (error) {
+            *error = reason;
+        }
+        return false;
+    };
+
+    if (!QDir().mkpath(m_storeDirectory)) {
+        return fail(QString("cannot create %1").arg(m_storeDirectory));
+    }
+    m_indexFile.setFileName(QDir(m_storeDirectory).filePath("index.bin"));
+    if (!m_indexFile.open(QIODevice::ReadWrite)) {
+        return fail(m_indexFile.errorString());
+    }
+
+    const qint64 indexBytes = qint64(sizeof(Header)) + qint64(sizeof(Slot)) * SLOT_COUNT;
+    const bool sized = m_indexFile.size() == indexBytes;
+    if (!sized && !m_indexFile.resize(indexBytes)) {
+        return fail(m_indexFile.errorString());
+    }
+    m_map = m_indexFile.map(0, indexBytes);
+    if (!m_map) {
+        return fail(m_indexFile.errorString());
+    }
+    m_header = reinterpret_cast<Header *>(m_map);
+    m_table = reinterpret_cast<Slot *>(m_map + sizeof(Header));
+
+    if (!sized || m_header->magic != INDEX_MAGIC || m_header->version != INDEX_VERSION
+        || m_header->bucketCount != BUCKET_COUNT || m_header->bucketWays != BUCKET_WAYS) {
+        qDebug() << "Rebuilding transcript cache index in" << m_directory;
+        resetIndex();
+    }
+
+    // 上限比上次运行时小时立即淘汰
+    trim();
+    qDebug() << "Transcript cache" << m_directory << "entries:" << entryCount() << "bytes:" << totalBytes();
+    return true;
+}
+
+void TranscriptCache::resetIndex()
+{
+    memset(m_map, 0, sizeof(Header) + sizeof(Slot) * SLOT_COUNT);
+    m_header->magic = INDEX_MAGIC;
+    m_header->version = INDEX_VERSION;
+    m_header->bucketCount = BUCKET_COUNT;
+    m_header->bucketWays = BUCKET_WAYS;
+
+    // 旧索引引用的文本已无从查找；只删除名称是键的十六进制形式的条目文件
+    QDir dir(m_storeDirectory);
+    for (const QString &name : dir.entryList({ QString("*") + ENTRY_SUFFIX }, QDir::Files)) {
+        if (isEntryName(name)) {
+            dir.remove(name);
+        }
+    }
+}
+
+QByteArray TranscriptCache::key(AudioFileSource &source, AudioEncoding encoding, const QUrl &endpoint)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    // 业务参数、录音格式、服务地址和实际上行的编码决定识别结果，与音频一起计入键。
+    // 流水线对构建时不支持的编码退回 raw 发送，这里同样处理
+    const QAudioFormat format = source.format();
+    const AudioEncoding uplinkEncoding = audioEncodingSupported(encoding) ? encoding : AudioEncoding::Raw;
+    hash.addData(IatFrameWriter::businessParameters());
+    hash.addData(audioEncodingName(uplinkEncoding) + ";");
+    hash.addData(endpoint.toEncoded() + ";");
+    hash.addData(QByteArray::number(format.sampleRate()) + "," + QByteArray::number(format.channelCount()) + ","
+                 + QByteArray::number(int(format.sampleFormat())) + ";");
+
+    for (QByteArrayView chunk = source.read(HASH_CHUNK_BYTES); !chunk.isEmpty();
+         chunk = source.read(HASH_CHUNK_BYTES)) {
+        hash.addData(chunk);
+    }
+    source.rewind();
+    return hash.result();
+}
+
+QFuture<QByteArray> TranscriptCache::keyAsync(const QString &path, const QAudioFormat &rawFormat,
+                                              AudioEncoding encoding, const QUrl &endpoint)
+{
+    // QPromise 只能移动，任务对象需要可拷贝，借 shared_ptr 传入
+    auto promise = std::make_shared<QPromise<QByteArray>>();
+    QFuture<QByteArray> future = promise->future();
+    promise->start();
+    QThreadPool::globalInstance()->start([promise, path, rawFormat, encoding, endpoint]() {
+        AudioFileSource source;
+        QString error;
+        QByteArray result;
+        if (source.open(path, rawFormat, &error)) {
+            result = key(source, encoding, endpoint);
+        } else {
+            qDebug() << "Cannot hash" << path << ":" << error;
+        }
+        promise->addResult(result);
+        promise->finish();
+    });
+    return future;
+}
+
+TranscriptCache::Slot *TranscriptCache::findSlot(const QByteArray &key) const
+{
+    Slot *bucket = m_table + bucketOf(key.constData()) * BUCKET_WAYS;
+    for (int way = 0; way < BUCKET_WAYS; ++way) {
+        if (bucket[way].lastUse != 0 && memcmp(bucket[way].key, key.constData(), KEY_BYTES) == 0) {
+            return &bucket[way];
+        }
+    }
+    return nullptr;
+}
+
+bool TranscriptCache::lookup(const QByteArray &key, QString *text)
+{
+    if (!isOpen() || key.size() != KEY_BYTES) {
+        return false;
+    }
+    Slot *slot = findSlot(key);
+    if (!slot) {
+        return false;
+    }
+
+    QFile file(textPath(slot->key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        // 文本文件已被外部删除，作废这个条目
+        evict(slot);
+        return false;
+    }
+    *text = QString::fromUtf8(file.readAll());
+    slot->lastUse = ++m_header->useCounter;
+    return true;
+}
+
+void TranscriptCache::insert(const QByteArray &key, const QString &text)
+{
+    if (!isOpen() || key.size() != KEY_BYTES) {
+        return;
+    }
+    const QByteArray utf8 = text.toUtf8();
+    if (utf8.size() > m_maxBytes) {
+        return;
+    }
+
+    Slot *slot = findSlot(key);
+    if (slot) {
+        m_header->totalBytes -= slot->textBytes;
+    } else {
+        // 优先使用空槽位 (使用序号为 0)，桶满时替换桶内最久未用的条目
+        Slot *bucket = m_table + bucketOf(key.constData()) * BUCKET_WAYS;
+        slot = bucket;
+        for (int way = 1; way < BUCKET_WAYS; ++way) {
+            if (bucket[way].lastUse < slot->lastUse) {
+                slot = &bucket[way];
+            }
+        }
+        if (slot->lastUse != 0) {
+            evict(slot);
+        }
+        memcpy(slot->key, key.constData(), KEY_BYTES);
+    }
+
+    // 先写文本再更新索引，中途退出时索引不会指向写了一半的文件
+    const QString path = textPath(slot->key);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(utf8) != utf8.size() || !file.commit()) {
+        qDebug() << "Failed to write cached transcript" << path << ":" << file.errorString();
+        QFile::remove(path);
+        slot->textBytes = 0;
+        slot->lastUse = 0;
+        return;
+    }
+
+    slot->textBytes = quint32(utf8.size());
+    slot->lastUse = ++m_header->useCounter;
+    m_header->totalBytes += slot->textBytes;
+    trim();
+}
+
+void TranscriptCache::trim()
+{
+    while (m_header->totalBytes > quint64(m_maxBytes)) {
+        Slot *oldest = nullptr;
+        for (int i = 0; i < SLOT_COUNT; ++i) {
+            if (m_table[i].lastUse != 0 && (!oldest || m_table[i].lastUse < oldest->lastUse)) {
+                oldest = &m_table[i];
+            }
+        }
+        if (!oldest) {
+            m_header->totalBytes = 0;
+            break;
+        }
+        evict(oldest);
+    }
+}
+
+void TranscriptCache::evict(Slot *slot)
+{
+    QFile::remove(textPath(slot->key));
+    m_header->totalBytes -= qMin<quint64>(slot->textBytes, m_header->totalBytes);
+    memset(slot, 0, sizeof(Slot));
+}
+
+QString TranscriptCache::textPath(const uchar *key) const
+{
+    const QByteArray name = QByteArray(reinterpret_cast<const char *>(key), KEY_BYTES).toHex();
+    return QDir(m_storeDirectory).filePath(QString::fromLatin1(name) + ENTRY_SUFFIX);
+}
+
+int TranscriptCache::entryCount() const
+{
+    if (!isOpen()) {
+        return 0;
+    }
+    int count = 0;
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        count += m_table[i].lastUse != 0 ? 1 : 0;
+    }
+    return count;
+}
+
+qint64 TranscriptCache::totalBytes() const
+{
+    return isOpen() ? qint64(m_header->totalBytes) : 0;
+}
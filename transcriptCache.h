@@ -0,0 +1,77 @@
+#ifndef TRANSCRIPTCACHE_H
+#define TRANSCRIPTCACHE_H
+
+#include "audioCodec.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QFuture>
+#include <QString>
+
+class AudioFileSource;
+class QAudioFormat;
+class QUrl;
+
+// 按内容寻址的识别结果缓存：同一段音频再次提交时直接返回上次的最终文本，不再连接服务。
+// 键为音频数据 (不含文件头)、录音格式、业务参数、上行编码和服务地址的 SHA-1，其中任一项不同的同一段音频互不命中。
+// 索引文件 index.bin 内存映射，为 BUCKET_COUNT 个桶、每桶 BUCKET_WAYS 个槽位的组相联表，
+// 每个槽位记录键、文本字节数和最近使用序号；文本按键的十六进制名称存为单独的 .transcript 文件。
+// 索引和文本都放在缓存目录下专用的 transcript-cache 子目录中，重建索引时只删除其中符合键名格式的文件，
+// 缓存目录本身可以是任意已有目录。
+// 桶满时替换桶内最久未用的槽位，文本总量超过上限时按最近使用序号淘汰全局最旧的条目。
+// 只在创建它的线程中使用，同一目录同时只能被一个进程打开。
+class TranscriptCache
+{
+public:
+    static constexpr qint64 DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+    // 不超过此大小 (约 2 分钟 16k 音频) 的音频可以在调用线程中直接计算键，只需几毫秒；
+    // 更大的文件应使用 keyAsync()，一边计算一边开始发送
+    static constexpr qint64 SYNC_KEY_MAX_BYTES = 4 * 1024 * 1024;
+
+    explicit TranscriptCache(const QString &directory, qint64 maxBytes = DEFAULT_MAX_BYTES);
+    ~TranscriptCache();
+
+    TranscriptCache(const TranscriptCache &) = delete;
+    TranscriptCache &operator=(const TranscriptCache &) = delete;
+
+    // 创建目录并映射索引；索引损坏或版本不符时清空重建。失败时返回 false 并写明原因
+    bool open(QString *error = nullptr);
+    bool isOpen() const { return m_table != nullptr; }
+    QString directory() const { return m_directory; }
+
+    // 计算音频的缓存键：读完 source 的全部数据后回到开头，映射的文件不产生拷贝。
+    // encoding 和 endpoint 取自将要识别它的流水线，构建时不支持的编码与 raw 视为相同
+    static QByteArray key(AudioFileSource &source, AudioEncoding encoding, const QUrl &endpoint);
+    // 同上，在线程池中另行打开 path 计算，不阻塞调用线程，也不影响流水线同时读取同一文件；
+    // rawFormat 与 AudioFileSource::open() 相同。文件打不开时结果为空
+    static QFuture<QByteArray> keyAsync(const QString &path, const QAudioFormat &rawFormat, AudioEncoding encoding,
+                                        const QUrl &endpoint);
+
+    // 命中时写出文本并刷新最近使用序号
+    bool lookup(const QByteArray &key, QString *text);
+    void insert(const QByteArray &key, const QString &text);
+
+    int entryCount() const;
+    qint64 totalBytes() const;
+
+private:
+    struct Header;
+    struct Slot;
+
+    Slot *findSlot(const QByteArray &key) const;
+    void evict(Slot *slot);
+    // 文本总量超过上限时按最近使用序号淘汰最旧的条目
+    void trim();
+    QString textPath(const uchar *key) const;
+    void resetIndex();
+
+    QString m_directory;
+    QString m_storeDirectory;  // 索引和文本所在的专用子目录
+    qint64 m_maxBytes;
+    QFile m_indexFile;
+    uchar *m_map = nullptr;
+    Header *m_header = nullptr;
+    Slot *m_table = nullptr;
+};
+
+#endif // TRANSCRIPTCACHE_H
@@ -0,0 +1,87 @@
+#include "transcriptModel.h"
+
+TranscriptModel::TranscriptModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int TranscriptModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_transcript.size();
+}
+
+QVariant TranscriptModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_transcript.size()) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return m_transcript.segment(index.row()).text;
+    case StableRole:
+        return m_transcript.isStable(index.row());
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TranscriptModel::roleNames() const
+{
+    return {
+        { TextRole, "text" },
+        { StableRole, "stable" },
+    };
+}
+
+void TranscriptModel::applyResult(const RecognitionResult &result)
+{
+    const Transcript::Edit edit = m_transcript.plan(result);
+
+    // [row, row + removed) 被替换为 inserted 行：重叠部分原地更新，多出的部分删除或插入
+    const int changed = qMin(edit.removed, edit.inserted);
+    if (edit.removed > edit.inserted) {
+        beginRemoveRows(QModelIndex(), edit.row + edit.inserted, edit.row + edit.removed - 1);
+    } else if (edit.inserted > edit.removed) {
+        beginInsertRows(QModelIndex(), edit.row + edit.removed, edit.row + edit.inserted - 1);
+    }
+
+    m_transcript.apply(result);
+
+    if (edit.removed > edit.inserted) {
+        endRemoveRows();
+    } else if (edit.inserted > edit.removed) {
+        endInsertRows();
+    }
+
+    if (changed > 0) {
+        emit dataChanged(index(edit.row), index(edit.row + changed - 1), { TextRole, Qt::DisplayRole });
+    }
+
+    // 稳定区间只会向后扩展；被替换的分段已在上面更新
+    const int stableFirst = qMin(edit.stableBefore, edit.stableAfter);
+    const int stableLast = qMin(qMax(edit.stableBefore, edit.stableAfter), m_transcript.size()) - 1;
+    if (stableLast >= stableFirst) {
+        emit dataChanged(index(stableFirst), index(stableLast), { StableRole });
+    }
+
+    if (edit.removed != edit.inserted) {
+        emit countChanged();
+    }
+    if (edit.removed > 0 || edit.inserted > 0 || edit.stableBefore != edit.stableAfter) {
+        emit transcriptChanged(edit.row);
+    }
+}
+
+void TranscriptModel::clear()
+{
+    if (m_transcript.isEmpty()) {
+        return;
+    }
+    beginResetModel();
+    m_transcript.clear();
+    endResetModel();
+    emit countChanged();
+    emit transcriptChanged(0);
+}
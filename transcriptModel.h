@@ -0,0 +1,43 @@
+#ifndef TRANSCRIPTMODEL_H
+#define TRANSCRIPTMODEL_H
+
+#include <QAbstractListModel>
+
+#include "transcript.h"
+
+// Transcript 的列表模型，每行一个结果分段，供 QML ListView 显示
+// 每条结果只发出受影响行的插入/删除/数据变化通知，
+// 界面只需重新布局变化的分段，长时间会话中开销不随全文长度增长。
+class TranscriptModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        TextRole = Qt::UserRole + 1,
+        StableRole   // 分段不会再被替换
+    };
+
+    explicit TranscriptModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void applyResult(const RecognitionResult &result);
+    void clear();
+
+    const Transcript &transcript() const { return m_transcript; }
+    Q_INVOKABLE QString text() const { return m_transcript.text(); }
+
+signals:
+    void countChanged();
+    // 内容变化，row 为第一个受影响的行
+    void transcriptChanged(int row);
+
+private:
+    Transcript m_transcript;
+};
+
+#endif // TRANSCRIPTMODEL_H
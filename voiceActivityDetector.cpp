@@ -0,0 +1,99 @@
+#include "voiceActivityDetector.h"
+#include "audioKernels.h"
+#include "iatProtocol.h"
+
+#include <cmath>
+
+namespace {
+constexpr double SILENCE_DB = -120.0;          // 全零块的能量
+constexpr double NOISE_FLOOR_FALL_RATE = 0.5;  // 噪声底下降较快，迅速适应安静环境
+constexpr double NOISE_FLOOR_RISE_RATE = 0.05;
+constexpr double SPEECH_FLOOR_RISE_RATE = 0.002;  // 语音块也缓慢抬升噪声底，防止持续噪声被一直当作语音
+
+qsizetype samplesForMs(int ms)
+{
+    return qsizetype(ms) * SAMPLE_RATE / 1000;
+}
+}
+
+VoiceActivityDetector::VoiceActivityDetector()
+    : VoiceActivityDetector(Config())
+{
+}
+
+VoiceActivityDetector::VoiceActivityDetector(const Config &config)
+    : m_config(config)
+    , m_noiseFloorDb(config.initialNoiseFloorDb)
+{
+}
+
+void VoiceActivityDetector::setConfig(const Config &config)
+{
+    m_config = config;
+    reset();
+}
+
+void VoiceActivityDetector::reset()
+{
+    m_noiseFloorDb = m_config.initialNoiseFloorDb;
+    m_hangoverSamples = 0;
+}
+
+bool VoiceActivityDetector::analyzeFrame(QByteArrayView pcm)
+{
+    if (!m_config.enabled) {
+        return true;
+    }
+
+    const qint16 *samples = reinterpret_cast<const qint16 *>(pcm.data());
+    const qsizetype sampleCount = pcm.size() / 2;
+    const qsizetype blockSamples = qMax<qsizetype>(1, samplesForMs(m_config.blockMs));
+    const qsizetype hangoverSamples = samplesForMs(m_config.hangoverMs);
+
+    // 所有块都要分析，保证噪声底和 hangover 状态连续
+    bool active = false;
+    for (qsizetype offset = 0; offset < sampleCount; offset += blockSamples) {
+        const qsizetype count = qMin(blockSamples, sampleCount - offset);
+        if (isSpeechBlock(samples + offset, count)) {
+            m_hangoverSamples = hangoverSamples;
+            active = true;
+        } else if (m_hangoverSamples > 0) {
+            m_hangoverSamples -= count;
+            active = true;
+        }
+    }
+    return active;
+}
+
+int VoiceActivityDetector::paddingFrames(qsizetype frameBytes) const
+{
+    if (!m_config.enabled || m_config.paddingMs <= 0 || frameBytes <= 0) {
+        return 0;
+    }
+    const qsizetype paddingBytes = qsizetype(m_config.paddingMs) * BYTES_PER_MS;
+    return int((paddingBytes + frameBytes - 1) / frameBytes);
+}
+
+bool VoiceActivityDetector::isSpeechBlock(const qint16 *samples, qsizetype count)
+{
+    const quint64 sumOfSquares = audioSumOfSquares(samples, count);
+    const double meanSquare = double(sumOfSquares) / count;
+    const double energyDb = meanSquare > 0 ? 10 * std::log10(meanSquare / (32768.0 * 32768.0))
+                                           : SILENCE_DB;
+    const double zcr = count > 1 ? double(audioZeroCrossings(samples, count)) / (count - 1) : 0.0;
+
+    const double margin = energyDb - m_noiseFloorDb;
+    const bool voiced = margin >= m_config.speechMarginDb;
+    const bool unvoiced = margin >= m_config.unvoicedMarginDb && zcr >= m_config.minUnvoicedZcr;
+    const bool speech = energyDb >= m_config.minSpeechDb && (voiced || unvoiced);
+
+    // 噪声底跟踪：静音块快速下降、较慢上升
+    double rate = SPEECH_FLOOR_RISE_RATE;
+    if (!speech) {
+        rate = energyDb < m_noiseFloorDb ? NOISE_FLOOR_FALL_RATE : NOISE_FLOOR_RISE_RATE;
+    }
+    m_noiseFloorDb += (energyDb - m_noiseFloorDb) * rate;
+    m_noiseFloorDb = qMax(m_noiseFloorDb, SILENCE_DB);
+
+    return speech;
+}
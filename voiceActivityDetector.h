@@ -0,0 +1,53 @@
+#ifndef VOICEACTIVITYDETECTOR_H
+#define VOICEACTIVITYDETECTOR_H
+
+#include <QByteArrayView>
+#include <QtGlobal>
+
+// 语音活动检测：把每帧 16k/16bit 单声道音频切成短分析块，
+// 根据块能量相对自适应噪声底的高度判断浊音，能量略高且过零率高的块判为清音 (s、sh 等)。
+// 语音块之后的 hangover 时间内仍视为语音，避免截断词尾和字间停顿。
+// 一帧中只要有一个块是语音 (或处于 hangover 内)，整帧就需要发送。
+class VoiceActivityDetector
+{
+public:
+    struct Config
+    {
+        bool enabled = true;              // 关闭时所有帧都发送
+        int blockMs = 20;                 // 分析块长度
+        double speechMarginDb = 12.0;     // 块能量高出噪声底多少判为浊音
+        double unvoicedMarginDb = 6.0;    // 清音的能量余量，需同时满足过零率条件
+        double minUnvoicedZcr = 0.3;      // 清音最小过零率 (每个样本)
+        double minSpeechDb = -55.0;       // 绝对能量下限 (相对满幅)，低于此值一律视为静音
+        double initialNoiseFloorDb = -60.0;
+        int hangoverMs = 400;             // 最后一个语音块之后继续视为语音的时长
+        int paddingMs = 400;              // 语音开始前额外发送的音频，避免截断词首
+        int utteranceEndMs = 600;         // 听音模式：hangover 之后持续静音这么久视为一句话结束
+    };
+
+    VoiceActivityDetector();
+    explicit VoiceActivityDetector(const Config &config);
+
+    const Config &config() const { return m_config; }
+    void setConfig(const Config &config);
+
+    // 开始新会话前调用，恢复初始噪声底并清除 hangover
+    void reset();
+
+    // 分析一帧音频，返回该帧是否需要发送
+    bool analyzeFrame(QByteArrayView pcm);
+
+    // 语音开始前需要保留的帧数
+    int paddingFrames(qsizetype frameBytes) const;
+
+    double noiseFloorDb() const { return m_noiseFloorDb; }
+
+private:
+    bool isSpeechBlock(const qint16 *samples, qsizetype count);
+
+    Config m_config;
+    double m_noiseFloorDb;
+    qsizetype m_hangoverSamples = 0;  // hangover 剩余样本数
+};
+
+#endif // VOICEACTIVITYDETECTOR_H